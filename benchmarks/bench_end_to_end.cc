@@ -0,0 +1,354 @@
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/inotify.h>
+#include <sys/resource.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <iterator>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <optional>
+#include <exception>
+#include <stdexcept>
+#include <filesystem>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "benchmark_maps.h"
+
+/**
+ * bench_end_to_end - benchmarks whole myrobot runs (algorithm loading, house parsing, scheduling, simulation and output)
+ * over a generated corpus of maze and corridor houses (see BenchmarkMaps), with 1 up to (the number of cores) simulating threads.
+ *
+ * Each run is a separate myrobot process, run in a directory of its own. Besides its wall time, each run reports:
+ * - `simulations_per_second` and `steps_per_second` (by the run's performance.csv).
+ * - `first_result_ms` - the time until the run wrote its first output file.
+ * - `peak_rss_bytes` - the process's peak resident memory.
+ * - `parallel_efficiency` - the run's throughput relative to the single-threaded run's, per thread (if both were run).
+ *
+ * Usage: bench_end_to_end [-myrobot=<path>] [-algo_path=<path>] [-num_houses=<num>] [-side=<num>] [--benchmark_...]
+ * (myrobot and the algorithms are looked up next to bench_end_to_end by default)
+ */
+
+namespace Constants
+{
+    const std::string kMyrobotArgument = "-myrobot=";
+    const std::string kAlgorithmPathArgument = "-algo_path=";
+    const std::string kNumHousesArgument = "-num_houses=";
+    const std::string kSideArgument = "-side=";
+    const std::string kMyrobotName = "myrobot";
+    const std::string kHouseExtension = ".house";
+    const std::string kOutputExtension = ".txt";
+    const std::string kPerformanceFileName = "performance.csv";
+
+    const std::size_t kDefaultNumHouses = 64;
+    const std::size_t kDefaultSide = 16;
+    const std::size_t kStepsPerCell = 2;            // A house's MaxSteps, per cell.
+    const std::size_t kBatteryPerSide = 4;          // A house's MaxBattery, per row.
+    const int kPollIntervalMs = 1;
+
+    // Open plan and rooms layouts are left out - the in-tree algorithms' path searches blow up on open areas,
+    // so their pairs time out (measuring the time budgets, rather than the pipeline's throughput).
+    const MapLayout kCorpusLayouts[] = { MapLayout::Maze, MapLayout::Corridor };
+}
+
+struct BenchmarkArguments
+{
+    std::filesystem::path myrobot_path;
+    std::filesystem::path algorithm_path;
+    std::size_t num_houses = Constants::kDefaultNumHouses;
+    std::size_t side = Constants::kDefaultSide;
+    std::filesystem::path house_path;               // The generated corpus.
+};
+
+/**
+ * @brief The measurements of a single myrobot run.
+ */
+struct RunResult
+{
+    std::chrono::duration<double> wall_time;
+    std::optional<std::chrono::duration<double>> first_result_time;
+    std::size_t peak_rss_bytes;
+    std::size_t num_simulations;
+    std::size_t num_steps;
+};
+
+namespace
+{
+    BenchmarkArguments benchmark_arguments;
+    std::optional<double> single_thread_throughput;   // The single-threaded run's simulations per second.
+}
+
+/**
+ * @brief Sums up the simulations and steps of a run, by its performance.csv.
+ */
+void readPerformance(const std::filesystem::path& performance_path, RunResult& run_result)
+{
+    std::ifstream performance_file(performance_path);
+    if (!performance_file.is_open())
+    {
+        throw std::runtime_error("myrobot wrote no " + Constants::kPerformanceFileName);
+    }
+
+    std::string line;
+    std::getline(performance_file, line);   // Header
+
+    while (std::getline(performance_file, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        // Algo,House,NumSteps,...
+        std::istringstream line_stream(line);
+        std::string algorithm_name, house_name, num_steps;
+        std::getline(line_stream, algorithm_name, ',');
+        std::getline(line_stream, house_name, ',');
+        std::getline(line_stream, num_steps, ',');
+
+        run_result.num_simulations++;
+        run_result.num_steps += std::stoul(num_steps);
+    }
+}
+
+/**
+ * @brief Runs myrobot in a given directory, until it exits.
+ *
+ * @throws std::runtime_error If myrobot couldn't be run, or failed.
+ */
+RunResult runMyrobot(std::size_t num_threads, const std::filesystem::path& run_path)
+{
+    // Output files are watched from before the run starts, so the first one can't be missed
+    int inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (-1 == inotify_fd || -1 == inotify_add_watch(inotify_fd, run_path.c_str(), IN_CLOSE_WRITE))
+    {
+        throw std::runtime_error("Couldn't watch the run's directory");
+    }
+
+    std::string house_path_argument = "-house_path=" + benchmark_arguments.house_path.string();
+    std::string algorithm_path_argument = "-algo_path=" + benchmark_arguments.algorithm_path.string();
+    std::string num_threads_argument = "-num_threads=" + std::to_string(num_threads);
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    pid_t pid = fork();
+    if (0 == pid)
+    {
+        int null_fd = open("/dev/null", O_WRONLY);
+        if (-1 == chdir(run_path.c_str()) || -1 == null_fd || -1 == dup2(null_fd, STDOUT_FILENO) || -1 == dup2(null_fd, STDERR_FILENO))
+        {
+            _exit(EXIT_FAILURE);
+        }
+
+        execl(benchmark_arguments.myrobot_path.c_str(), Constants::kMyrobotName.c_str(),
+              house_path_argument.c_str(), algorithm_path_argument.c_str(), num_threads_argument.c_str(), nullptr);
+        _exit(EXIT_FAILURE);
+    }
+
+    if (-1 == pid)
+    {
+        close(inotify_fd);
+        throw std::runtime_error("Couldn't fork myrobot");
+    }
+
+    RunResult run_result = {};
+    int status = 0;
+    rusage usage = {};
+
+    while (true)
+    {
+        pollfd poll_fd = { .fd = inotify_fd, .events = POLLIN, .revents = 0 };
+        poll(&poll_fd, 1, Constants::kPollIntervalMs);
+
+        alignas(inotify_event) char events[4096];
+        ssize_t events_size = 0;
+        while ((events_size = read(inotify_fd, events, sizeof(events))) > 0)
+        {
+            for (char* event_pointer = events; event_pointer < events + events_size;)
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(event_pointer);
+                event_pointer += sizeof(inotify_event) + event->len;
+
+                if (!run_result.first_result_time.has_value() && 0 != event->len && std::string_view(event->name).ends_with(Constants::kOutputExtension))
+                {
+                    run_result.first_result_time = std::chrono::steady_clock::now() - start_time;
+                }
+            }
+        }
+
+        if (pid == wait4(pid, &status, WNOHANG, &usage))
+        {
+            break;
+        }
+    }
+
+    run_result.wall_time = std::chrono::steady_clock::now() - start_time;
+    close(inotify_fd);
+
+    if (!WIFEXITED(status) || EXIT_SUCCESS != WEXITSTATUS(status))
+    {
+        throw std::runtime_error("myrobot failed (wait status " + std::to_string(status) + ")");
+    }
+
+    run_result.peak_rss_bytes = static_cast<std::size_t>(usage.ru_maxrss) * 1024;    // ru_maxrss is in kilobytes
+    readPerformance(run_path / Constants::kPerformanceFileName, run_result);
+
+    return run_result;
+}
+
+void benchmarkEndToEnd(benchmark::State& state)
+{
+    std::size_t num_threads = static_cast<std::size_t>(state.range(0));
+    std::filesystem::path run_path = benchmark_arguments.house_path.parent_path() / ("run-" + std::to_string(num_threads));
+
+    RunResult total = {};
+    double first_result_seconds = 0;
+
+    for (auto _ : state)
+    {
+        std::filesystem::remove_all(run_path);
+        std::filesystem::create_directories(run_path);
+
+        try
+        {
+            RunResult run_result = runMyrobot(num_threads, run_path);
+
+            state.SetIterationTime(run_result.wall_time.count());
+            total.wall_time += run_result.wall_time;
+            total.peak_rss_bytes = std::max(total.peak_rss_bytes, run_result.peak_rss_bytes);
+            total.num_simulations += run_result.num_simulations;
+            total.num_steps += run_result.num_steps;
+            first_result_seconds += run_result.first_result_time.value_or(run_result.wall_time).count();
+        }
+
+        catch (const std::exception& exception)
+        {
+            state.SkipWithError(exception.what());
+            break;
+        }
+    }
+
+    std::filesystem::remove_all(run_path);
+
+    if (0 == total.num_simulations)
+    {
+        return;
+    }
+
+    double simulations_per_second = static_cast<double>(total.num_simulations) / total.wall_time.count();
+    if (1 == num_threads)
+    {
+        single_thread_throughput = simulations_per_second;
+    }
+
+    state.counters["simulations_per_second"] = simulations_per_second;
+    state.counters["steps_per_second"] = static_cast<double>(total.num_steps) / total.wall_time.count();
+    state.counters["first_result_ms"] = 1000 * first_result_seconds / static_cast<double>(state.iterations());
+    state.counters["peak_rss_bytes"] = static_cast<double>(total.peak_rss_bytes);
+
+    if (single_thread_throughput.has_value())
+    {
+        state.counters["parallel_efficiency"] = simulations_per_second / (single_thread_throughput.value() * static_cast<double>(num_threads));
+    }
+}
+
+/**
+ * @brief Writes the corpus - houses of the corpus layouts in turn (see BenchmarkMaps).
+ */
+void writeCorpus()
+{
+    std::filesystem::create_directories(benchmark_arguments.house_path);
+
+    std::size_t side = benchmark_arguments.side;
+    for (std::size_t i = 0; i < benchmark_arguments.num_houses; i++)
+    {
+        MapLayout layout = Constants::kCorpusLayouts[i % std::size(Constants::kCorpusLayouts)];
+        std::string house_name = BenchmarkMaps::getLayoutName(layout) + "_" + std::to_string(i);
+
+        BenchmarkMaps::writeHouseFile(benchmark_arguments.house_path / (house_name + Constants::kHouseExtension),
+                                      layout,
+                                      side,
+                                      Constants::kStepsPerCell * side * side,
+                                      Constants::kBatteryPerSide * side);
+    }
+}
+
+void parseArguments(int argc, char* argv[])
+{
+    std::filesystem::path binary_path = std::filesystem::canonical("/proc/self/exe").parent_path();
+    benchmark_arguments.myrobot_path = binary_path / Constants::kMyrobotName;
+    benchmark_arguments.algorithm_path = binary_path;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view argument = argv[i];
+
+        if (argument.starts_with(Constants::kMyrobotArgument))
+        {
+            benchmark_arguments.myrobot_path = std::filesystem::absolute(argument.substr(Constants::kMyrobotArgument.size()));
+        }
+
+        else if (argument.starts_with(Constants::kAlgorithmPathArgument))
+        {
+            benchmark_arguments.algorithm_path = std::filesystem::absolute(argument.substr(Constants::kAlgorithmPathArgument.size()));
+        }
+
+        else if (argument.starts_with(Constants::kNumHousesArgument))
+        {
+            benchmark_arguments.num_houses = std::stoul(std::string(argument.substr(Constants::kNumHousesArgument.size())));
+        }
+
+        else if (argument.starts_with(Constants::kSideArgument))
+        {
+            benchmark_arguments.side = std::stoul(std::string(argument.substr(Constants::kSideArgument.size())));
+        }
+
+        else
+        {
+            throw std::invalid_argument("Usage: bench_end_to_end [-myrobot=<path>] [-algo_path=<path>] [-num_houses=<num>] [-side=<num>] [--benchmark_...]");
+        }
+    }
+
+    std::filesystem::path work_path = std::filesystem::temp_directory_path() / ("bench_end_to_end-" + std::to_string(getpid()));
+    benchmark_arguments.house_path = work_path / "houses";
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark::Initialize(&argc, argv);
+
+    try
+    {
+        parseArguments(argc, argv);
+        writeCorpus();
+    }
+
+    catch (const std::exception& exception)
+    {
+        std::cerr << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    benchmark::RegisterBenchmark("EndToEnd", &benchmarkEndToEnd)
+        ->ArgName("threads")
+        ->DenseRange(1, std::max<int>(1, static_cast<int>(std::thread::hardware_concurrency())))
+        ->UseManualTime()
+        ->Unit(benchmark::kMillisecond);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    std::filesystem::remove_all(benchmark_arguments.house_path.parent_path());
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,298 @@
+#include <map>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <filesystem>
+
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include "common/enums.h"
+
+#include "simulator/simulator.h"
+#include "simulator/deserializer.h"
+#include "simulator/status.h"
+
+#include "output_handler.h"
+#include "benchmark_maps.h"
+
+/**
+ * bench_io - benchmarks the simulator's file I/O: parsing house files (Deserializer::readHouseFile(), on house files
+ * of 1KB up to 100MB), and writing output files (OutputHandler::exportStatistics(), on step histories of 10^3 up to 10^7
+ * steps, and OutputHandler::exportSummary(), on score matrices of 10x10 up to 1000x1000).
+ *
+ * Besides the time per file, each benchmark reports its throughput in bytes per second (`bytes_per_second`), and the
+ * read / write syscalls it makes per file (`syscalls`) and per item - a house cell, a step or a score (`syscalls_per_item`).
+ * Syscalls are counted by the process' I/O accounting (`syscr` / `syscw` of /proc/self/io), so opening and closing files
+ * isn't counted.
+ *
+ * The files are written into (and removed from) a temporary directory, which is also the working directory of the run.
+ *
+ * Usage: bench_io [--benchmark_filter=<regex>] [--benchmark_out=<file> --benchmark_out_format=json] [--benchmark_...]
+ */
+
+namespace Constants
+{
+    const std::string kIoAccountingPath = "/proc/self/io";
+    const std::string kReadSyscallsField = "syscr:";
+    const std::string kWriteSyscallsField = "syscw:";
+    const std::string kWorkingDirectoryPrefix = "bench_io-";
+    const std::string kHouseFileName = "house.house";
+    const std::string kAlgorithmName = "Algorithm";
+    const std::string kHouseName = "House";
+
+    const std::int64_t kMinHouseBytes = 1000;
+    const std::int64_t kMaxHouseBytes = 100000000;
+    const std::int64_t kMinSteps = 1000;
+    const std::int64_t kMaxSteps = 10000000;
+    const std::int64_t kMinSummarySide = 10;
+    const std::int64_t kMaxSummarySide = 1000;
+    const MapLayout kHouseLayout = MapLayout::Rooms;    // Walls, dirt and empty cells alike.
+}
+
+/**
+ * @brief A snapshot of the process' read / write syscalls counters.
+ */
+struct IoCounters
+{
+    std::int64_t read_syscalls = 0;
+    std::int64_t write_syscalls = 0;
+};
+
+/**
+ * @brief Reads the process' read / write syscalls counters (reading them makes read syscalls of its own - see snapshot_cost).
+ *
+ * @throws std::runtime_error If the process' I/O accounting isn't available.
+ */
+IoCounters readIoCounters()
+{
+    std::ifstream io_accounting(Constants::kIoAccountingPath);
+    if (!io_accounting.is_open())
+    {
+        throw std::runtime_error("Couldn't open " + Constants::kIoAccountingPath + " (is task I/O accounting enabled?)");
+    }
+
+    IoCounters io_counters;
+    std::string field;
+    std::int64_t value;
+
+    while (io_accounting >> field >> value)
+    {
+        if (Constants::kReadSyscallsField == field)
+        {
+            io_counters.read_syscalls = value;
+        }
+
+        else if (Constants::kWriteSyscallsField == field)
+        {
+            io_counters.write_syscalls = value;
+        }
+    }
+
+    return io_counters;
+}
+
+namespace
+{
+    IoCounters snapshot_cost;   // The syscalls counted between two consecutive snapshots (subtracted from each measurement).
+}
+
+/**
+ * @brief Counts the read and write syscalls made since a given snapshot.
+ */
+std::int64_t countSyscallsSince(const IoCounters& start_counters)
+{
+    IoCounters end_counters = readIoCounters();
+
+    return (end_counters.read_syscalls - start_counters.read_syscalls - snapshot_cost.read_syscalls)
+        + (end_counters.write_syscalls - start_counters.write_syscalls - snapshot_cost.write_syscalls);
+}
+
+/**
+ * @brief Removes the output files written into the working directory.
+ *
+ * @return The total size of the removed files.
+ */
+std::uintmax_t removeOutputFiles()
+{
+    std::uintmax_t total_size = 0;
+
+    for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::current_path()))
+    {
+        if (entry.is_regular_file() && Constants::kHouseFileName != entry.path().filename())
+        {
+            total_size += entry.file_size();
+            std::filesystem::remove(entry.path());
+        }
+    }
+
+    return total_size;
+}
+
+/**
+ * @brief Reports the per-file counters of an I/O benchmark.
+ */
+void reportIoCounters(benchmark::State& state, std::int64_t total_bytes, std::int64_t num_items, std::int64_t total_syscalls)
+{
+    state.SetBytesProcessed(total_bytes);
+    state.counters["syscalls"] = benchmark::Counter(static_cast<double>(total_syscalls), benchmark::Counter::kAvgIterations);
+    state.counters["syscalls_per_item"] = static_cast<double>(total_syscalls) / static_cast<double>(state.iterations() * num_items);
+}
+
+void benchmarkReadHouseFile(benchmark::State& state)
+{
+    // A house file of a side of N takes about N^2 bytes
+    std::size_t side = std::max<std::size_t>(3, static_cast<std::size_t>(std::sqrt(static_cast<double>(state.range(0)))));
+    BenchmarkMaps::writeHouseFile(Constants::kHouseFileName, Constants::kHouseLayout, side, side, side);
+
+    std::int64_t file_size = static_cast<std::int64_t>(std::filesystem::file_size(Constants::kHouseFileName));
+    std::int64_t total_syscalls = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        IoCounters start_counters = readIoCounters();
+        state.ResumeTiming();
+        HouseFile house_file;
+
+        Deserializer::readHouseFile(Constants::kHouseFileName, house_file);
+        benchmark::DoNotOptimize(house_file);
+
+        state.PauseTiming();
+        total_syscalls += countSyscallsSince(start_counters);
+        state.ResumeTiming();
+    }
+
+    std::filesystem::remove(Constants::kHouseFileName);
+
+    state.counters["side"] = static_cast<double>(side);
+    reportIoCounters(state, state.iterations() * file_size, static_cast<std::int64_t>(side * side), total_syscalls);
+}
+
+void benchmarkExportStatistics(benchmark::State& state)
+{
+    static constexpr const Step kStepsCycle[] = { Step::North, Step::East, Step::Stay, Step::South, Step::West };
+
+    std::size_t num_steps = static_cast<std::size_t>(state.range(0));
+
+    SimulationStatistics statistics;
+    statistics.num_steps_taken = num_steps;
+    statistics.dirt_left = 0;
+    statistics.is_at_docking_station = true;
+    statistics.mission_status = Status::Finished;
+
+    statistics.step_history.reserve(num_steps);
+    for (std::size_t i = 0; i < num_steps; i++)
+    {
+        statistics.step_history.push_back(kStepsCycle[i % std::size(kStepsCycle)]);
+    }
+
+    std::int64_t total_bytes = 0;
+    std::int64_t total_syscalls = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        IoCounters start_counters = readIoCounters();
+        state.ResumeTiming();
+
+        OutputHandler::exportStatistics(Constants::kAlgorithmName, Constants::kHouseName, statistics, num_steps);
+
+        state.PauseTiming();
+        total_syscalls += countSyscallsSince(start_counters);
+        total_bytes += static_cast<std::int64_t>(removeOutputFiles());
+        state.ResumeTiming();
+    }
+
+    reportIoCounters(state, total_bytes, static_cast<std::int64_t>(num_steps), total_syscalls);
+}
+
+void benchmarkExportSummary(benchmark::State& state)
+{
+    std::size_t side = static_cast<std::size_t>(state.range(0));
+
+    std::map<std::string, std::map<std::string, std::size_t>> scores;
+    for (std::size_t algorithm_index = 0; algorithm_index < side; algorithm_index++)
+    {
+        std::string algorithm_name = Constants::kAlgorithmName + std::to_string(algorithm_index);
+
+        for (std::size_t house_index = 0; house_index < side; house_index++)
+        {
+            scores[algorithm_name][Constants::kHouseName + std::to_string(house_index)] = algorithm_index * side + house_index;
+        }
+    }
+
+    std::int64_t total_bytes = 0;
+    std::int64_t total_syscalls = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        IoCounters start_counters = readIoCounters();
+        state.ResumeTiming();
+
+        OutputHandler::exportSummary(scores);
+
+        state.PauseTiming();
+        total_syscalls += countSyscallsSince(start_counters);
+        total_bytes += static_cast<std::int64_t>(removeOutputFiles());
+        state.ResumeTiming();
+    }
+
+    reportIoCounters(state, total_bytes, static_cast<std::int64_t>(side * side), total_syscalls);
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::path working_directory = std::filesystem::temp_directory_path() / (Constants::kWorkingDirectoryPrefix + std::to_string(getpid()));
+    std::filesystem::path original_directory = std::filesystem::current_path();
+
+    try
+    {
+        IoCounters first_snapshot = readIoCounters();
+        IoCounters second_snapshot = readIoCounters();
+        snapshot_cost.read_syscalls = second_snapshot.read_syscalls - first_snapshot.read_syscalls;
+        snapshot_cost.write_syscalls = second_snapshot.write_syscalls - first_snapshot.write_syscalls;
+
+        std::filesystem::create_directories(working_directory);
+        std::filesystem::current_path(working_directory);
+    }
+
+    catch (const std::exception& exception)
+    {
+        std::cerr << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    benchmark::RegisterBenchmark("ReadHouseFile", &benchmarkReadHouseFile)
+        ->RangeMultiplier(10)->Range(Constants::kMinHouseBytes, Constants::kMaxHouseBytes)->Unit(benchmark::kMillisecond);
+
+    benchmark::RegisterBenchmark("ExportStatistics", &benchmarkExportStatistics)
+        ->RangeMultiplier(10)->Range(Constants::kMinSteps, Constants::kMaxSteps)->Unit(benchmark::kMillisecond);
+
+    benchmark::RegisterBenchmark("ExportSummary", &benchmarkExportSummary)
+        ->RangeMultiplier(10)->Range(Constants::kMinSummarySide, Constants::kMaxSummarySide)->Unit(benchmark::kMillisecond);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    std::filesystem::current_path(original_directory);
+    std::filesystem::remove_all(working_directory);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,274 @@
+#include <deque>
+#include <queue>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+
+#include <benchmark/benchmark.h>
+
+#include "common/battery_meter.h"
+#include "common/position.h"
+#include "common/enums.h"
+
+#include "algorithm/base_algorithm.h"
+#include "algorithm/path_tree.h"
+
+#include "memory_tracker.h"
+#include "benchmark_maps.h"
+
+/**
+ * bench_pathfinding - benchmarks the algorithms' path finding primitives on known maps (see BenchmarkMaps),
+ * at 16x16 up to 1024x1024: BaseAlgorithm's path searches, and raw PathTree insertion and backtracking.
+ *
+ * Searches start at the map's center (which serves as the docking station). The whole map is known, as if it was explored,
+ * with the cells at distance kTodoDistance from the center left to visit - a frontier, as when an exploration is underway.
+ *
+ * Besides the time per query, each benchmark reports the path tree nodes (`nodes`) and the heap allocations (`allocations`) per query.
+ * Results are comparable across commits in JSON (e.g. by Google Benchmark's tools/compare.py):
+ *
+ * Usage: bench_pathfinding [--benchmark_filter=<regex>] [--benchmark_out=<file> --benchmark_out_format=json] [--benchmark_...]
+ */
+
+namespace Constants
+{
+    const std::size_t kMinSide = 16;
+    const std::size_t kMaxSide = 1024;
+    const std::size_t kTodoDistance = 6;            // The distance of the todo positions (the frontier) from the center.
+    const std::size_t kTargetDistance = 8;          // The distance of getPathToPosition()'s target from the center.
+    const std::size_t kBatteryCapacity = 1000;
+}
+
+class FullBatteryMeter : public BatteryMeter
+{
+public:
+    std::size_t getBatteryState() const override { return Constants::kBatteryCapacity; }
+};
+
+/**
+ * @brief A BaseAlgorithm over a known map, exposing its path searches.
+ */
+class MappedAlgorithm : public BaseAlgorithm
+{
+    FullBatteryMeter battery_meter;
+    Position target_position;                       // A position at distance kTargetDistance from the center (if the map has one).
+
+    bool getPathToNextTarget(const Position& start_position, std::deque<Direction>& path) override
+    {
+        return getPathToNearestTodo(start_position, path);
+    }
+
+public:
+    /**
+     * @brief Maps a whole map, relatively to its center (see the file's comment).
+     */
+    MappedAlgorithm(MapLayout layout, std::size_t side);
+
+    using BaseAlgorithm::getPathToNearestTodo;
+    using BaseAlgorithm::getPathToPosition;
+    using BaseAlgorithm::isCleanedAllReachable;
+    using BaseAlgorithm::getLastPathTreeSize;
+
+    const Position& getTargetPosition() const { return target_position; }
+};
+
+MappedAlgorithm::MappedAlgorithm(MapLayout layout, std::size_t side)
+{
+    std::vector<std::string> map = BenchmarkMaps::build(layout, side);
+    auto [center_row, center_column] = BenchmarkMaps::findCenter(map);
+
+    // Distances from the center (by BFS), for picking the todo and target positions
+    std::vector<std::size_t> distances(side * side, SIZE_MAX);
+    std::queue<std::pair<std::size_t, std::size_t>> cell_queue;
+
+    distances[center_row * side + center_column] = 0;
+    cell_queue.push({center_row, center_column});
+
+    while (!cell_queue.empty())
+    {
+        auto [row, column] = cell_queue.front();
+        cell_queue.pop();
+
+        for (Direction direction : kDirections)
+        {
+            Position neighbor = Position::computePosition(Position(static_cast<int>(row), static_cast<int>(column)), direction);
+            std::size_t neighbor_row = static_cast<std::size_t>(neighbor.first);
+            std::size_t neighbor_column = static_cast<std::size_t>(neighbor.second);
+
+            if (BenchmarkMaps::isWall(map, neighbor_row, neighbor_column) || SIZE_MAX != distances[neighbor_row * side + neighbor_column])
+            {
+                continue;
+            }
+
+            distances[neighbor_row * side + neighbor_column] = distances[row * side + column] + 1;
+            cell_queue.push({neighbor_row, neighbor_column});
+        }
+    }
+
+    setMaxSteps(SIZE_MAX / 2);
+    setBatteryMeter(battery_meter);
+
+    bool is_target_set = false;
+    for (std::size_t row = 0; row < side; row++)
+    {
+        for (std::size_t column = 0; column < side; column++)
+        {
+            Position position(static_cast<int>(row) - static_cast<int>(center_row), static_cast<int>(column) - static_cast<int>(center_column));
+            std::size_t distance = distances[row * side + column];
+
+            mapPosition(position, BenchmarkMaps::isWall(map, row, column), Constants::kTodoDistance == distance);
+
+            if (Constants::kTargetDistance == distance && !is_target_set)
+            {
+                target_position = position;
+                is_target_set = true;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Reports the per-query counters of a path search benchmark.
+ */
+void reportQueryCounters(benchmark::State& state, std::size_t num_nodes, std::int64_t num_allocations)
+{
+    state.SetItemsProcessed(state.iterations());
+    state.counters["nodes"] = static_cast<double>(num_nodes);
+    state.counters["allocations"] = benchmark::Counter(static_cast<double>(num_allocations), benchmark::Counter::kAvgIterations);
+}
+
+std::int64_t getNumAllocations()
+{
+    return MemoryTracker::getThreadUsage().num_allocations.load(std::memory_order_relaxed);
+}
+
+void benchmarkNearestTodo(benchmark::State& state, MapLayout layout)
+{
+    MappedAlgorithm algorithm(layout, static_cast<std::size_t>(state.range(0)));
+    std::int64_t start_allocations = getNumAllocations();
+
+    for (auto _ : state)
+    {
+        std::deque<Direction> path;
+        benchmark::DoNotOptimize(algorithm.getPathToNearestTodo(Position(0, 0), path));
+    }
+
+    reportQueryCounters(state, algorithm.getLastPathTreeSize(), getNumAllocations() - start_allocations);
+}
+
+void benchmarkPathToPosition(benchmark::State& state, MapLayout layout)
+{
+    MappedAlgorithm algorithm(layout, static_cast<std::size_t>(state.range(0)));
+    std::int64_t start_allocations = getNumAllocations();
+
+    for (auto _ : state)
+    {
+        std::deque<Direction> path;
+        benchmark::DoNotOptimize(algorithm.getPathToPosition(Position(0, 0), algorithm.getTargetPosition(), path, Constants::kTargetDistance));
+    }
+
+    reportQueryCounters(state, algorithm.getLastPathTreeSize(), getNumAllocations() - start_allocations);
+}
+
+void benchmarkCleanedAllReachable(benchmark::State& state, MapLayout layout)
+{
+    MappedAlgorithm algorithm(layout, static_cast<std::size_t>(state.range(0)));
+    std::int64_t start_allocations = getNumAllocations();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(algorithm.isCleanedAllReachable());
+    }
+
+    reportQueryCounters(state, algorithm.getLastPathTreeSize(), getNumAllocations() - start_allocations);
+}
+
+/**
+ * @brief Inserts a single branch (a straight path) of a given depth - each node copies its branch's visited positions.
+ */
+std::size_t insertBranch(PathTree& path_tree, std::size_t depth)
+{
+    std::size_t node_index = path_tree.insertRoot(Position(0, 0));
+
+    for (int i = 1; i <= static_cast<int>(depth); i++)
+    {
+        node_index = path_tree.insertChild(node_index, Direction::East, Position(0, i), false).value();
+    }
+
+    return node_index;
+}
+
+void benchmarkPathTreeInsert(benchmark::State& state)
+{
+    std::size_t depth = static_cast<std::size_t>(state.range(0));
+    std::int64_t start_allocations = getNumAllocations();
+
+    for (auto _ : state)
+    {
+        PathTree path_tree;
+        benchmark::DoNotOptimize(insertBranch(path_tree, depth));
+    }
+
+    reportQueryCounters(state, depth + 1, getNumAllocations() - start_allocations);
+}
+
+void benchmarkPathTreeBacktrack(benchmark::State& state)
+{
+    std::size_t depth = static_cast<std::size_t>(state.range(0));
+
+    PathTree path_tree;
+    std::size_t end_index = insertBranch(path_tree, depth);
+    std::int64_t start_allocations = getNumAllocations();
+
+    for (auto _ : state)
+    {
+        // As BaseAlgorithm reconstructs a found path
+        std::deque<Direction> path;
+        std::size_t current_index = end_index;
+        while (path_tree.hasParent(current_index))
+        {
+            path.push_front(path_tree.getDirection(current_index));
+            current_index = path_tree.getParentIndex(current_index);
+        }
+
+        benchmark::DoNotOptimize(path);
+    }
+
+    reportQueryCounters(state, depth + 1, getNumAllocations() - start_allocations);
+}
+
+void registerBenchmarks()
+{
+    for (MapLayout layout : BenchmarkMaps::kLayouts)
+    {
+        std::string layout_name = BenchmarkMaps::getLayoutName(layout);
+
+        benchmark::RegisterBenchmark(("NearestTodo/" + layout_name).c_str(), &benchmarkNearestTodo, layout)
+            ->RangeMultiplier(4)->Range(Constants::kMinSide, Constants::kMaxSide);
+
+        benchmark::RegisterBenchmark(("PathToPosition/" + layout_name).c_str(), &benchmarkPathToPosition, layout)
+            ->RangeMultiplier(4)->Range(Constants::kMinSide, Constants::kMaxSide);
+
+        benchmark::RegisterBenchmark(("CleanedAllReachable/" + layout_name).c_str(), &benchmarkCleanedAllReachable, layout)
+            ->RangeMultiplier(4)->Range(Constants::kMinSide, Constants::kMaxSide);
+    }
+
+    benchmark::RegisterBenchmark("PathTree/insert", &benchmarkPathTreeInsert)->RangeMultiplier(4)->Range(Constants::kMinSide, Constants::kMaxSide);
+    benchmark::RegisterBenchmark("PathTree/backtrack", &benchmarkPathTreeBacktrack)->RangeMultiplier(4)->Range(Constants::kMinSide, Constants::kMaxSide);
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    registerBenchmarks();
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,215 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <filesystem>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "common/AlgorithmRegistrar.h"
+#include "common/abstract_algorithm.h"
+
+#include "simulator/deserializer.h"
+
+#include "input_handler.h"
+#include "task_queue.h"
+#include "benchmark_maps.h"
+
+/**
+ * bench_scheduler - benchmarks the scheduling overhead TaskQueue and Task add per algorithm - house pair (a thread spawn,
+ * the threads semaphore, arming and cancelling the timeout timer and the tasks latch), apart from any simulation cost.
+ *
+ * Each pair runs the NoopAlgorithm plugin (which finishes on its first step) on a tiny house, for 10^4 up to 10^6 pairs.
+ * Each task's start is the time of its algorithm's first call. Besides the pairs per second, the intervals between
+ * consecutive task starts are reported (`interval_p50_us` ... `interval_max_us`) - with a single thread, an interval
+ * is the whole cost of finishing a task and dispatching the next one.
+ *
+ * A TaskQueue keeps its tasks' finished worker threads (and their stacks) until it's destroyed, so the pairs are run
+ * through consecutive queues of up to kMaxQueuePairs pairs each (as a batched myrobot run would).
+ *
+ * Usage: bench_scheduler [-algo_path=<path>] [--benchmark_...]
+ * (the plugin is looked up in the benchmark_algorithms directory next to bench_scheduler by default)
+ */
+
+namespace Constants
+{
+    const std::string kAlgorithmPathArgument = "-algo_path=";
+    const std::string kAlgorithmDirectoryName = "benchmark_algorithms";
+    const std::string kNoopAlgorithmName = "NoopAlgorithm";
+
+    const std::int64_t kMinPairs = 10000;
+    const std::int64_t kMaxPairs = 1000000;
+    const std::int64_t kThreadCounts[] = { 1, 10 };     // A single thread, and myrobot's default.
+    const std::size_t kMaxQueuePairs = 10000;           // Pairs per TaskQueue (see the file's comment).
+    const std::size_t kHouseSide = 3;                   // A single empty cell - the docking station.
+}
+
+using TimePoint = std::chrono::steady_clock::time_point;
+
+/**
+ * @brief Records the time of an algorithm's first call (forwarding all calls to it).
+ */
+class TimestampingAlgorithm final : public AbstractAlgorithm
+{
+    std::unique_ptr<AbstractAlgorithm> algorithm;
+    TimePoint& start_time;
+    bool is_started = false;
+
+public:
+    TimestampingAlgorithm(std::unique_ptr<AbstractAlgorithm>&& algorithm, TimePoint& start_time)
+        : algorithm(std::move(algorithm)), start_time(start_time) {}
+
+    void setMaxSteps(std::size_t max_steps) override { algorithm->setMaxSteps(max_steps); }
+    void setWallsSensor(const WallsSensor& walls_sensor) override { algorithm->setWallsSensor(walls_sensor); }
+    void setDirtSensor(const DirtSensor& dirt_sensor) override { algorithm->setDirtSensor(dirt_sensor); }
+    void setBatteryMeter(const BatteryMeter& battery_meter) override { algorithm->setBatteryMeter(battery_meter); }
+
+    Step nextStep() override
+    {
+        if (!is_started)
+        {
+            start_time = std::chrono::steady_clock::now();
+            is_started = true;
+        }
+
+        return algorithm->nextStep();
+    }
+};
+
+namespace
+{
+    AlgorithmFactory noop_algorithm_factory;
+}
+
+double getPercentile(const std::vector<std::chrono::nanoseconds>& sorted_intervals, double percentile)
+{
+    std::size_t index = static_cast<std::size_t>(percentile * static_cast<double>(sorted_intervals.size() - 1));
+    return std::chrono::duration<double, std::micro>(sorted_intervals[index]).count();
+}
+
+void benchmarkScheduler(benchmark::State& state)
+{
+    std::size_t num_pairs = static_cast<std::size_t>(state.range(0));
+    std::size_t num_threads = static_cast<std::size_t>(state.range(1));
+
+    HouseFile house_file = BenchmarkMaps::buildHouseFile(MapLayout::Open, Constants::kHouseSide, 1, 1);
+    std::string algorithm_name = Constants::kNoopAlgorithmName;
+
+    std::vector<std::chrono::nanoseconds> intervals;
+
+    for (auto _ : state)
+    {
+        std::vector<TimePoint> start_times(num_pairs);
+        std::chrono::nanoseconds run_time = std::chrono::nanoseconds::zero();
+
+        for (std::size_t first_pair = 0; first_pair < num_pairs; first_pair += Constants::kMaxQueuePairs)
+        {
+            std::size_t num_queue_pairs = std::min(Constants::kMaxQueuePairs, num_pairs - first_pair);
+            TaskQueue task_queue(num_queue_pairs, num_threads);
+
+            for (std::size_t i = first_pair; i < first_pair + num_queue_pairs; i++)
+            {
+                task_queue.insertTask(algorithm_name, std::make_unique<TimestampingAlgorithm>(noop_algorithm_factory(), start_times[i]), house_file);
+            }
+
+            TimePoint run_start_time = std::chrono::steady_clock::now();
+            task_queue.run();
+            run_time += std::chrono::steady_clock::now() - run_start_time;
+
+            // Intervals are taken within a queue only (not across the next queue's set-up)
+            std::sort(start_times.begin() + first_pair, start_times.begin() + first_pair + num_queue_pairs);
+
+            TimePoint previous_start_time = run_start_time;
+            for (std::size_t i = first_pair; i < first_pair + num_queue_pairs; i++)
+            {
+                intervals.push_back(start_times[i] - previous_start_time);
+                previous_start_time = start_times[i];
+            }
+        }
+
+        state.SetIterationTime(std::chrono::duration<double>(run_time).count());
+    }
+
+    std::sort(intervals.begin(), intervals.end());
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * num_pairs));
+    state.counters["interval_p50_us"] = getPercentile(intervals, 0.5);
+    state.counters["interval_p99_us"] = getPercentile(intervals, 0.99);
+    state.counters["interval_p999_us"] = getPercentile(intervals, 0.999);
+    state.counters["interval_max_us"] = getPercentile(intervals, 1);
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark::Initialize(&argc, argv);
+
+    std::filesystem::path algorithm_path = std::filesystem::canonical("/proc/self/exe").parent_path() / Constants::kAlgorithmDirectoryName;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view argument = argv[i];
+
+        if (argument.starts_with(Constants::kAlgorithmPathArgument))
+        {
+            algorithm_path = argument.substr(Constants::kAlgorithmPathArgument.size());
+        }
+
+        else
+        {
+            std::cerr << "Usage: bench_scheduler [-algo_path=<path>] [--benchmark_...]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<void*> algorithm_handles;
+
+    try
+    {
+        InputHandler::openAlgorithms(algorithm_path.string(), algorithm_handles);
+
+        for (const auto& algorithm : AlgorithmRegistrar::getAlgorithmRegistrar())
+        {
+            if (Constants::kNoopAlgorithmName == algorithm.name())
+            {
+                noop_algorithm_factory = [&algorithm]() { return algorithm.create(); };
+            }
+        }
+
+        if (!noop_algorithm_factory)
+        {
+            throw std::runtime_error(Constants::kNoopAlgorithmName + " wasn't found in " + algorithm_path.string());
+        }
+    }
+
+    catch (const std::exception& exception)
+    {
+        std::cerr << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    benchmark::internal::Benchmark* scheduler_benchmark = benchmark::RegisterBenchmark("Scheduler", &benchmarkScheduler);
+    for (std::int64_t num_threads : Constants::kThreadCounts)
+    {
+        for (std::int64_t num_pairs = Constants::kMinPairs; num_pairs <= Constants::kMaxPairs; num_pairs *= 10)
+        {
+            scheduler_benchmark->Args({num_pairs, num_threads});
+        }
+    }
+
+    scheduler_benchmark->ArgNames({"pairs", "threads"})->Iterations(1)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    noop_algorithm_factory = nullptr;
+    AlgorithmRegistrar::getAlgorithmRegistrar().clear();
+    InputHandler::closeAlgorithms(algorithm_handles);
+
+    return EXIT_SUCCESS;
+}
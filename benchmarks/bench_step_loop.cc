@@ -0,0 +1,166 @@
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "common/abstract_algorithm.h"
+#include "common/enums.h"
+
+#include "simulator/simulator.h"
+#include "simulator/deserializer.h"
+
+#include "memory_tracker.h"
+#include "benchmark_maps.h"
+
+/**
+ * bench_step_loop - benchmarks the simulator's own per-step overhead (moving, checking walls and dirt, charging and
+ * discharging the battery and recording the step history), with no path planning in the loop.
+ *
+ * The simulated algorithm replays a precomputed tour of its house (see computeTour()), at no cost of its own.
+ * Houses are built from BenchmarkMaps, at 16x16 up to 1024x1024. Each benchmark reports the steps per second,
+ * and the heap bytes (`bytes_per_step`) and allocations (`allocations_per_step`) the simulation takes per step.
+ *
+ * Usage: bench_step_loop [--benchmark_filter=<regex>] [--benchmark_out=<file> --benchmark_out_format=json] [--benchmark_...]
+ */
+
+namespace Constants
+{
+    const std::size_t kMinSide = 16;
+    const std::size_t kMaxSide = 1024;
+}
+
+/**
+ * @brief An algorithm replaying a precomputed sequence of steps (ignoring its sensors).
+ */
+class ScriptedAlgorithm final : public AbstractAlgorithm
+{
+    const std::vector<Step>& script;
+    std::size_t next_step_index = 0;
+
+public:
+    explicit ScriptedAlgorithm(const std::vector<Step>& script) : script(script) {}
+
+    void setMaxSteps(std::size_t) override {}
+    void setWallsSensor(const WallsSensor&) override {}
+    void setDirtSensor(const DirtSensor&) override {}
+    void setBatteryMeter(const BatteryMeter&) override {}
+
+    Step nextStep() override { return script[next_step_index++]; }
+};
+
+/**
+ * @brief Computes a tour of all cells reachable from the docking station (by DFS), cleaning each dirty cell on the way,
+ *        and finishing back at the docking station.
+ */
+std::vector<Step> computeTour(const House& house)
+{
+    static constexpr const Direction kDirections[] = { Direction::North, Direction::East, Direction::South, Direction::West };
+
+    std::size_t num_rows = house.getRowsCount();
+    std::size_t num_columns = house.getColumnsCount();
+    Position docking_station = house.getDockingStationPosition();
+
+    std::vector<Step> tour;
+    std::vector<bool> is_visited(num_rows * num_columns, false);
+    std::vector<std::pair<Position, std::size_t>> stack = {{docking_station, 0}};    // A cell, and its next direction to explore.
+
+    is_visited[docking_station.first * num_columns + docking_station.second] = true;
+
+    while (!stack.empty())
+    {
+        auto& [position, direction_index] = stack.back();
+
+        if (4 == direction_index)
+        {
+            stack.pop_back();
+            if (!stack.empty())
+            {
+                // Back to the parent cell - opposite to the direction the parent was left by
+                Direction forward_direction = kDirections[stack.back().second - 1];
+                tour.push_back(static_cast<Step>((static_cast<int>(forward_direction) + 2) % 4));
+            }
+
+            continue;
+        }
+
+        Direction direction = kDirections[direction_index++];
+        Position neighbor = Position::computePosition(position, direction);
+
+        if (house.isWallAt(neighbor.first, neighbor.second) || is_visited[neighbor.first * num_columns + neighbor.second])
+        {
+            continue;
+        }
+
+        is_visited[neighbor.first * num_columns + neighbor.second] = true;
+        tour.push_back(static_cast<Step>(direction));
+        tour.insert(tour.end(), house.getDirtLevelAt(neighbor.first, neighbor.second), Step::Stay);
+        stack.push_back({neighbor, 0});
+    }
+
+    tour.push_back(Step::Finish);
+    return tour;
+}
+
+void benchmarkStepLoop(benchmark::State& state, MapLayout layout)
+{
+    std::size_t side = static_cast<std::size_t>(state.range(0));
+
+    // The tour is computed on the house first - then the house is built again, with just enough steps and battery for it
+    std::vector<Step> tour = computeTour(BenchmarkMaps::buildHouseFile(layout, side, 0, 0).house);
+    std::size_t num_steps = tour.size() - 1;
+    HouseFile house_file = BenchmarkMaps::buildHouseFile(layout, side, num_steps, num_steps + 1);
+
+    std::int64_t total_bytes = 0;
+    std::int64_t total_allocations = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Simulator simulator(house_file);
+        ScriptedAlgorithm algorithm(tour);
+        simulator.setAlgorithm(algorithm);
+        MemoryTracker::resetThreadUsage();
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(simulator.run(algorithm));
+
+        state.PauseTiming();
+        MemoryTracker::ThreadUsage& usage = MemoryTracker::getThreadUsage();
+        total_bytes += usage.peak_bytes.load(std::memory_order_relaxed);
+        total_allocations += usage.num_allocations.load(std::memory_order_relaxed);
+
+        if (simulator.getSimulationStatistics().num_steps_taken != num_steps)
+        {
+            state.SkipWithError("The tour was cut short - the simulation doesn't match its house");
+        }
+        state.ResumeTiming();
+    }
+
+    double total_steps = static_cast<double>(state.iterations() * num_steps);
+    state.SetItemsProcessed(static_cast<std::int64_t>(total_steps));
+    state.counters["steps"] = static_cast<double>(num_steps);
+    state.counters["bytes_per_step"] = static_cast<double>(total_bytes) / total_steps;
+    state.counters["allocations_per_step"] = static_cast<double>(total_allocations) / total_steps;
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    for (MapLayout layout : BenchmarkMaps::kLayouts)
+    {
+        benchmark::RegisterBenchmark(("StepLoop/" + BenchmarkMaps::getLayoutName(layout)).c_str(), &benchmarkStepLoop, layout)
+            ->RangeMultiplier(4)->Range(Constants::kMinSide, Constants::kMaxSide)->Unit(benchmark::kMillisecond);
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return EXIT_SUCCESS;
+}
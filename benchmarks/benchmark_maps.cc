@@ -0,0 +1,222 @@
+#include "benchmark_maps.h"
+
+#include <random>
+#include <fstream>
+#include <utility>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+
+std::vector<std::string> BenchmarkMaps::build(MapLayout layout, std::size_t side)
+{
+    if (side < 3)
+    {
+        throw std::invalid_argument("A benchmark map's side must be at least 3");
+    }
+
+    std::vector<std::string> map(side, std::string(side, kWall));
+
+    switch (layout)
+    {
+        case MapLayout::Open:
+            for (std::size_t row = 1; row + 1 < side; row++)
+            {
+                std::fill(map[row].begin() + 1, map[row].end() - 1, kEmpty);
+            }
+            break;
+
+        case MapLayout::Corridor:
+            buildCorridor(map);
+            break;
+
+        case MapLayout::Maze:
+            buildMaze(map);
+            break;
+
+        case MapLayout::Rooms:
+            buildRooms(map);
+            break;
+    }
+
+    return map;
+}
+
+std::string BenchmarkMaps::getLayoutName(MapLayout layout)
+{
+    switch (layout)
+    {
+        case MapLayout::Open: return "open";
+        case MapLayout::Corridor: return "corridor";
+        case MapLayout::Maze: return "maze";
+        case MapLayout::Rooms: return "rooms";
+    }
+
+    return "";
+}
+
+std::pair<std::size_t, std::size_t> BenchmarkMaps::findCenter(const std::vector<std::string>& map)
+{
+    std::size_t side = map.size();
+    std::pair<std::size_t, std::size_t> center;
+    std::size_t center_distance = SIZE_MAX;
+
+    for (std::size_t row = 0; row < side; row++)
+    {
+        for (std::size_t column = 0; column < side; column++)
+        {
+            std::size_t distance = static_cast<std::size_t>(std::abs(static_cast<long>(row) - static_cast<long>(side / 2))
+                                                          + std::abs(static_cast<long>(column) - static_cast<long>(side / 2)));
+
+            if (!isWall(map, row, column) && distance < center_distance)
+            {
+                center = {row, column};
+                center_distance = distance;
+            }
+        }
+    }
+
+    return center;
+}
+
+HouseFile BenchmarkMaps::buildHouseFile(MapLayout layout, std::size_t side, std::size_t max_steps, std::size_t max_battery)
+{
+    std::vector<std::string> map = build(layout, side);
+    auto [center_row, center_column] = findCenter(map);
+
+    std::vector<std::vector<bool>> wall_map(side, std::vector<bool>(side, false));
+    std::vector<std::vector<unsigned int>> dirt_map(side, std::vector<unsigned int>(side, 0));
+
+    for (std::size_t row = 0; row < side; row++)
+    {
+        for (std::size_t column = 0; column < side; column++)
+        {
+            bool is_docking_station = (center_row == row && center_column == column);
+
+            wall_map[row][column] = isWall(map, row, column);
+            dirt_map[row][column] = (isWall(map, row, column) || is_docking_station) ? 0 : getDirtLevel(row, column, side);
+        }
+    }
+
+    return {
+        .name = getLayoutName(layout) + "_" + std::to_string(side),
+        .max_steps = max_steps,
+        .battery = Battery(max_battery),
+        .house = House(std::move(wall_map), std::move(dirt_map), Position(static_cast<int>(center_row), static_cast<int>(center_column)))
+    };
+}
+
+void BenchmarkMaps::writeHouseFile(const std::filesystem::path& house_path, MapLayout layout, std::size_t side, std::size_t max_steps, std::size_t max_battery)
+{
+    std::vector<std::string> map = build(layout, side);
+    auto [center_row, center_column] = findCenter(map);
+
+    for (std::size_t row = 0; row < side; row++)
+    {
+        for (std::size_t column = 0; column < side; column++)
+        {
+            unsigned int dirt_level = getDirtLevel(row, column, side);
+            if (!isWall(map, row, column) && 0 != dirt_level)
+            {
+                map[row][column] = static_cast<char>('0' + dirt_level);
+            }
+        }
+    }
+
+    map[center_row][center_column] = kDockingStation;
+
+    std::ofstream house_file(house_path, std::ios::trunc);
+    house_file << house_path.stem().string() << "\n"
+               << "MaxSteps = " << max_steps << "\n"
+               << "MaxBattery = " << max_battery << "\n"
+               << "Rows = " << side << "\n"
+               << "Cols = " << side << "\n";
+
+    for (const std::string& row : map)
+    {
+        house_file << row << "\n";
+    }
+
+    if (!house_file.good())
+    {
+        throw std::runtime_error("Couldn't write house file \"" + house_path.string() + "\"");
+    }
+}
+
+void BenchmarkMaps::buildCorridor(std::vector<std::string>& map)
+{
+    // Odd rows are passages, linked by a gap in the wall row between them - alternately at its east and west ends
+    std::size_t side = map.size();
+    for (std::size_t row = 1; row + 1 < side; row++)
+    {
+        if (1 == row % 2)
+        {
+            std::fill(map[row].begin() + 1, map[row].end() - 1, kEmpty);
+        }
+
+        else
+        {
+            map[row][(0 == row % 4) ? 1 : side - 2] = kEmpty;
+        }
+    }
+}
+
+void BenchmarkMaps::buildMaze(std::vector<std::string>& map)
+{
+    // Passages are carved on odd coordinates (a maze cell is (2i + 1, 2j + 1)) by an iterative randomized DFS
+    std::size_t maze_side = (map.size() - 1) / 2;
+    std::mt19937_64 random(kMazeSeed);
+
+    std::vector<std::pair<std::size_t, std::size_t>> stack = {{0, 0}};
+    map[1][1] = kEmpty;
+
+    while (!stack.empty())
+    {
+        auto [maze_row, maze_column] = stack.back();
+
+        std::pair<std::size_t, std::size_t> neighbors[4];
+        std::size_t num_neighbors = 0;
+
+        auto addNeighbor = [&](std::size_t row, std::size_t column)
+        {
+            if (kWall == map[2 * row + 1][2 * column + 1])
+            {
+                neighbors[num_neighbors++] = {row, column};
+            }
+        };
+
+        if (maze_row > 0) addNeighbor(maze_row - 1, maze_column);
+        if (maze_row + 1 < maze_side) addNeighbor(maze_row + 1, maze_column);
+        if (maze_column > 0) addNeighbor(maze_row, maze_column - 1);
+        if (maze_column + 1 < maze_side) addNeighbor(maze_row, maze_column + 1);
+
+        if (0 == num_neighbors)
+        {
+            stack.pop_back();
+            continue;
+        }
+
+        auto [next_row, next_column] = neighbors[random() % num_neighbors];
+        map[maze_row + next_row + 1][maze_column + next_column + 1] = kEmpty;
+        map[2 * next_row + 1][2 * next_column + 1] = kEmpty;
+        stack.push_back({next_row, next_column});
+    }
+}
+
+void BenchmarkMaps::buildRooms(std::vector<std::string>& map)
+{
+    // A lattice of rooms, with a door in the middle of each wall between adjacent rooms
+    std::size_t side = map.size();
+    std::size_t door_offset = kRoomSize / 2;
+
+    for (std::size_t row = 1; row + 1 < side; row++)
+    {
+        for (std::size_t column = 1; column + 1 < side; column++)
+        {
+            bool is_room_wall = (0 == row % (kRoomSize - 1)) || (0 == column % (kRoomSize - 1));
+            bool is_door = (door_offset == row % (kRoomSize - 1)) || (door_offset == column % (kRoomSize - 1));
+
+            map[row][column] = (is_room_wall && !is_door) ? kWall : kEmpty;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef BENCHMARK_MAPS_H_
+#define BENCHMARK_MAPS_H_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <filesystem>
+
+#include "simulator/deserializer.h"
+
+/**
+ * @brief The layouts of the benchmarks' maps.
+ */
+enum class MapLayout { Open, Corridor, Maze, Rooms };
+
+/**
+ * @brief The BenchmarkMaps class builds the deterministic maps the benchmarks are run on.
+ *
+ * A map is a square grid of rows in the house file's notation (`W` for walls, a space for empty cells), surrounded by walls.
+ * Maps are a function of their layout and side only, so benchmark results are comparable across runs and commits.
+ * A map's center (its empty cell nearest to the middle) serves as its docking station.
+ */
+class BenchmarkMaps
+{
+    static constexpr const char kWall = 'W';
+    static constexpr const char kEmpty = ' ';
+    static constexpr const char kDockingStation = 'D';
+    static constexpr const std::size_t kRoomSize = 8;       // The side of a room, including its walls (rooms layout).
+    static constexpr const std::size_t kMazeSeed = 0;       // The seed of the maze layout's carving.
+    static constexpr const std::size_t kDirtyCellsPeriod = 4;   // Every 4th empty cell (in row-major order) is dirty.
+    static constexpr const unsigned int kMaxDirtLevel = 3;
+
+    static void buildCorridor(std::vector<std::string>& map);
+    static void buildMaze(std::vector<std::string>& map);
+    static void buildRooms(std::vector<std::string>& map);
+
+public:
+    inline static const MapLayout kLayouts[] = { MapLayout::Open, MapLayout::Corridor, MapLayout::Maze, MapLayout::Rooms };
+
+    /**
+    * @brief Deleted deault empty constructor.
+    *
+    * The default empty constructor is deleted since it's useless, as all the BenchmarkMaps member functions are `static`.
+    */
+    BenchmarkMaps() = delete;
+
+    /**
+     * @brief Builds a map.
+     *
+     * @param layout The map's layout - an open plan, a single winding corridor, a perfect maze or a lattice of connected rooms.
+     * @param side The number of rows (and columns) of the map (at least 3).
+     * @return The map's rows.
+     */
+    static std::vector<std::string> build(MapLayout layout, std::size_t side);
+
+    /**
+     * @brief Returns a layout's name (for benchmark names).
+     */
+    static std::string getLayoutName(MapLayout layout);
+
+    /**
+     * @brief Finds a map's center - its empty cell nearest to the middle of the map.
+     *
+     * @return The center's row and column.
+     */
+    static std::pair<std::size_t, std::size_t> findCenter(const std::vector<std::string>& map);
+
+    /**
+     * @brief Returns the dirt level of a cell in a house built from a map (see buildHouseFile()).
+     */
+    static unsigned int getDirtLevel(std::size_t row, std::size_t column, std::size_t side)
+    {
+        std::size_t cell_index = row * side + column;
+        return (0 == cell_index % kDirtyCellsPeriod) ? static_cast<unsigned int>(1 + (cell_index / kDirtyCellsPeriod) % kMaxDirtLevel) : 0;
+    }
+
+    /**
+     * @brief Builds a house from a map - with its docking station at the map's center, and dirt on its empty cells by getDirtLevel().
+     *
+     * @param layout The map's layout.
+     * @param side The number of rows (and columns) of the map.
+     * @param max_steps The house's maximal number of steps.
+     * @param max_battery The house's battery capacity.
+     * @return The house file.
+     */
+    static HouseFile buildHouseFile(MapLayout layout, std::size_t side, std::size_t max_steps, std::size_t max_battery);
+
+    /**
+     * @brief Writes a house built from a map (as buildHouseFile() does) into a house file.
+     *
+     * @param house_path The path of the house file to be written.
+     * @param layout The map's layout.
+     * @param side The number of rows (and columns) of the map.
+     * @param max_steps The house's maximal number of steps.
+     * @param max_battery The house's battery capacity.
+     *
+     * @throws std::runtime_error If the house file couldn't be written.
+     */
+    static void writeHouseFile(const std::filesystem::path& house_path, MapLayout layout, std::size_t side, std::size_t max_steps, std::size_t max_battery);
+
+    /**
+     * @brief Checks whether a map's cell is a wall.
+     */
+    static bool isWall(const std::vector<std::string>& map, std::size_t row, std::size_t column) { return kWall == map[row][column]; }
+};
+
+#endif /* BENCHMARK_MAPS_H_ */
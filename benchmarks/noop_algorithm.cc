@@ -0,0 +1,20 @@
+#include "common/abstract_algorithm.h"
+#include "common/enums.h"
+
+#include "algorithm/AlgorithmRegistration.h"
+
+/**
+ * @brief An algorithm which finishes right away (at the docking station) - so a simulation of it costs its scheduling only.
+ */
+class NoopAlgorithm final : public AbstractAlgorithm
+{
+public:
+    void setMaxSteps(std::size_t) override {}
+    void setWallsSensor(const WallsSensor&) override {}
+    void setDirtSensor(const DirtSensor&) override {}
+    void setBatteryMeter(const BatteryMeter&) override {}
+
+    Step nextStep() override { return Step::Finish; }
+};
+
+REGISTER_ALGORITHM(NoopAlgorithm);
@@ -0,0 +1,104 @@
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <exception>
+
+#include "common/AlgorithmRegistrar.h"
+
+#include "simulator/simulator.h"
+
+#include "output_handler.h"
+#include "input_handler.h"
+#include "sensor_trace.h"
+
+/**
+ * record_traces - simulates every algorithm - house pair, and records the sensor readings each algorithm saw
+ * into a `<house>-<algorithm>.trace` file (in the current directory), to be replayed by trace_benchmark.
+ *
+ * Usage: record_traces [-house_path=<path>] [-algo_path=<path>]
+ */
+
+namespace Constants
+{
+    const std::string kDefaultPath = ".";
+    const std::string kTraceExtension = ".trace";
+    const char kTraceSeparator = '-';
+}
+
+void recordTraces(const Arguments& arguments)
+{
+    std::vector<void*> algorithm_handles;
+    std::vector<std::filesystem::path> house_paths;
+    std::vector<HouseFile> house_files;
+
+    InputHandler::openAlgorithms(arguments.algorithm_path, algorithm_handles);
+
+    InputHandler::findHouses(arguments.house_path, house_paths);
+    InputHandler::readHouses(house_paths, house_files);
+
+    for (const auto& algorithm : AlgorithmRegistrar::getAlgorithmRegistrar())
+    {
+        for (const auto& house_file : house_files)
+        {
+            SensorTraceRecorder recorder(algorithm.create());
+            Simulator simulator(house_file);
+            simulator.setAlgorithm(recorder);
+
+            try
+            {
+                simulator.run();
+            }
+
+            catch (const std::exception& exception)
+            {
+                // The trace is kept up to the failing step
+                OutputHandler::printError(algorithm.name(), "[house=" + house_file.name + "]" + exception.what());
+            }
+
+            recorder.getTrace().save(house_file.name + Constants::kTraceSeparator + algorithm.name() + Constants::kTraceExtension);
+        }
+    }
+
+    AlgorithmRegistrar::getAlgorithmRegistrar().clear();
+    InputHandler::closeAlgorithms(algorithm_handles);
+}
+
+int main(int argc, char* argv[])
+{
+    Arguments arguments = {
+        .house_path = Constants::kDefaultPath,
+        .algorithm_path = Constants::kDefaultPath,
+        .num_threads = 1,
+        .summary_only = false,
+        .shard = std::nullopt,
+        .merge = false,
+        .cpu_timeout = false,
+        .wall_ceiling_factor = 1,
+        .isolate = false,
+        .daemon_socket = std::nullopt,
+        .step_slice = 0,
+        .replay_path = std::nullopt,
+        .cycle_check_interval = 0,
+        .batch_size = 0,
+        .step_latency = false,
+        .trace_path = std::nullopt,
+        .metrics_path = std::nullopt
+    };
+
+    try
+    {
+        bool is_success = InputHandler::parseCmdArguments(argc, argv, arguments);
+        if (is_success)
+        {
+            recordTraces(arguments);
+        }
+    }
+
+    catch(const std::exception& exception)
+    {
+        OutputHandler::printError("Main", exception.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
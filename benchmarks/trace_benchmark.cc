@@ -0,0 +1,148 @@
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+#include <iostream>
+#include <exception>
+#include <filesystem>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "common/AlgorithmRegistrar.h"
+
+#include "input_handler.h"
+#include "sensor_trace.h"
+
+/**
+ * trace_benchmark - replays recorded sensor traces (see record_traces) into algorithm builds, measuring the cost
+ * of the algorithms' nextStep() calls in isolation (with no simulator in the loop).
+ *
+ * Each `<house>-<algorithm>.trace` file is replayed into the algorithm registered by the same name.
+ * A build whose steps diverge from the recorded ones is replayed up to the divergence (see the `diverged` counter).
+ *
+ * Usage: trace_benchmark [-algo_path=<path>] [-trace_path=<path>] [--benchmark_...]
+ */
+
+namespace Constants
+{
+    const std::string kDefaultPath = ".";
+    const std::string kAlgorithmPathArgument = "-algo_path=";
+    const std::string kTracePathArgument = "-trace_path=";
+    const std::string kTraceExtension = ".trace";
+    const char kTraceSeparator = '-';
+}
+
+struct TraceFile
+{
+    std::string name;                       // The trace's `<house>-<algorithm>` name.
+    SensorTrace trace;
+};
+
+void replayTrace(benchmark::State& state, const AlgorithmFactory& algorithm_factory, const SensorTrace& trace)
+{
+    SensorTracePlayer player(trace);
+    std::size_t num_replayed_entries = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::unique_ptr<AbstractAlgorithm> algorithm_instance = algorithm_factory();
+        state.ResumeTiming();
+
+        num_replayed_entries = player.replay(*algorithm_instance);
+        benchmark::DoNotOptimize(num_replayed_entries);
+
+        state.PauseTiming();
+        algorithm_instance.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * num_replayed_entries));
+    state.counters["steps"] = static_cast<double>(num_replayed_entries);
+    state.counters["diverged"] = num_replayed_entries < trace.entries.size() ? 1 : 0;
+}
+
+void readTraces(const std::filesystem::path& trace_path, std::vector<TraceFile>& trace_files)
+{
+    for (const auto& entry : std::filesystem::directory_iterator(trace_path))
+    {
+        if (entry.is_regular_file() && Constants::kTraceExtension == entry.path().extension())
+        {
+            trace_files.push_back({
+                .name = entry.path().stem().string(),
+                .trace = SensorTrace::load(entry.path())
+            });
+        }
+    }
+}
+
+void registerBenchmarks(const std::vector<TraceFile>& trace_files)
+{
+    for (const auto& algorithm : AlgorithmRegistrar::getAlgorithmRegistrar())
+    {
+        std::string algorithm_suffix = Constants::kTraceSeparator + algorithm.name();
+
+        for (const auto& trace_file : trace_files)
+        {
+            if (trace_file.name.size() > algorithm_suffix.size() && trace_file.name.ends_with(algorithm_suffix))
+            {
+                AlgorithmFactory algorithm_factory = [&algorithm]() { return algorithm.create(); };
+                benchmark::RegisterBenchmark(trace_file.name.c_str(), &replayTrace, algorithm_factory, trace_file.trace);
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark::Initialize(&argc, argv);
+
+    std::string algorithm_path = Constants::kDefaultPath;
+    std::string trace_path = Constants::kDefaultPath;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view argument = argv[i];
+
+        if (argument.starts_with(Constants::kAlgorithmPathArgument))
+        {
+            algorithm_path = argument.substr(Constants::kAlgorithmPathArgument.size());
+        }
+
+        else if (argument.starts_with(Constants::kTracePathArgument))
+        {
+            trace_path = argument.substr(Constants::kTracePathArgument.size());
+        }
+
+        else
+        {
+            std::cerr << "Usage: trace_benchmark [-algo_path=<path>] [-trace_path=<path>] [--benchmark_...]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<void*> algorithm_handles;
+    std::vector<TraceFile> trace_files;
+
+    try
+    {
+        InputHandler::openAlgorithms(algorithm_path, algorithm_handles);
+        readTraces(trace_path, trace_files);
+    }
+
+    catch (const std::exception& exception)
+    {
+        std::cerr << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    registerBenchmarks(trace_files);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    AlgorithmRegistrar::getAlgorithmRegistrar().clear();
+    InputHandler::closeAlgorithms(algorithm_handles);
+
+    return EXIT_SUCCESS;
+}
@@ -3,7 +3,7 @@
 
 #include "algorithm/base_algorithm.h"
 
-class GreedyAlgorithm : public BaseAlgorithm
+class GreedyAlgorithm final : public BaseAlgorithm
 {
 public:
     bool getPathToNextTarget(const Position& start_position,
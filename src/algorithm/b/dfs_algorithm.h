@@ -5,7 +5,7 @@
 
 #include <stack>
 
-class DFSAlgorithm : public BaseAlgorithm
+class DFSAlgorithm final : public BaseAlgorithm
 {
     Position current_working_position;
     std::stack<Position> position_stack;
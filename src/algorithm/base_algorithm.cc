@@ -1,8 +1,10 @@
 #include "base_algorithm.h"
 
 #include "algorithm/AlgorithmRegistration.h"
+#include "common/tracepoints.h"
 
 #include <map>
+#include <algorithm>
 #include <cmath>
 #include <queue>
 #include <deque>
@@ -12,15 +14,19 @@
 std::optional<std::size_t> BaseAlgorithm::buildPathTree(PathTree& path_tree,
                                                         std::size_t max_depth,
                                                         std::size_t start_index,
-                                                        std::function<bool(const Position&)> const & found_criteria) const
+                                                        std::function<bool(const Position&)> const & found_criteria)
 {
     std::queue<std::size_t> index_queue;
     std::optional<std::size_t> path_end_index;
+    std::size_t nodes_expanded_before = planner_stats.nodes_expanded;
+
+    VACUUM_TRACEPOINT1(search__begin, max_depth);
 
     // If current position satisfies found_criteria - Return empty path
     if (found_criteria(path_tree.getPosition(start_index)))
     {
         path_end_index = start_index;
+        VACUUM_TRACEPOINT3(search__end, 0, path_tree.getNumNodes(), 1);
         return path_end_index;
     }
 
@@ -31,6 +37,7 @@ std::optional<std::size_t> BaseAlgorithm::buildPathTree(PathTree& path_tree,
     {
         std::size_t parent_index = index_queue.front();
         index_queue.pop();
+        planner_stats.nodes_expanded++;
 
         for (Direction direction : kDirections)
         {
@@ -62,7 +69,9 @@ std::optional<std::size_t> BaseAlgorithm::buildPathTree(PathTree& path_tree,
         }
     }
 
-    return path_tree.getBestEndNodeIndex();
+    path_end_index = path_tree.getBestEndNodeIndex();
+    VACUUM_TRACEPOINT3(search__end, planner_stats.nodes_expanded - nodes_expanded_before, path_tree.getNumNodes(), path_end_index.has_value() ? 1 : 0);
+    return path_end_index;
 }
 
 bool BaseAlgorithm::getPathByFoundCriteria(const Position& start_position,
@@ -75,6 +84,12 @@ bool BaseAlgorithm::getPathByFoundCriteria(const Position& start_position,
     std::size_t root_index = path_tree.insertRoot(start_position);
 
     auto path_end_index = buildPathTree(path_tree, max_length, root_index, found_criteria);
+    last_path_tree_size = path_tree.getNumNodes();
+
+    planner_stats.num_searches++;
+    planner_stats.path_tree_nodes += last_path_tree_size;
+    planner_stats.peak_path_tree_nodes = std::max(planner_stats.peak_path_tree_nodes, last_path_tree_size);
+
     if (!path_end_index.has_value())
     {
         return false;
@@ -143,10 +158,28 @@ bool BaseAlgorithm::getPathToPosition(const Position& start_position,
 
 bool BaseAlgorithm::getPathToStation(std::deque<Direction>& path)
 {
+    planner_stats.station_searches++;
     return getPathToPosition(current_tile.position, kDockingStationPosition, path);
 }
 
 void BaseAlgorithm::sampleWallSensor()
+{
+    std::uint8_t wall_mask = 0;
+
+    for (Direction direction : kDirections)
+    {
+        // Mapped positions are skipped by updateWallMap() - so their walls aren't sampled
+        Position position = Position::computePosition(current_tile.position, direction);
+        if (!house.wall_map.contains(position) && walls_sensor.value()->isWall(direction))
+        {
+            wall_mask |= SurroundingsSensor::getWallBit(direction);
+        }
+    }
+
+    updateWallMap(wall_mask);
+}
+
+void BaseAlgorithm::updateWallMap(std::uint8_t wall_mask)
 {
     for (Direction direction : kDirections)
     {
@@ -157,7 +190,7 @@ void BaseAlgorithm::sampleWallSensor()
             continue;
         }
 
-        bool is_wall = walls_sensor.value()->isWall(direction);
+        bool is_wall = SurroundingsSensor::isWall(wall_mask, direction);
         house.wall_map[position] = is_wall;
 
         if (is_wall)
@@ -171,9 +204,9 @@ void BaseAlgorithm::sampleWallSensor()
     house.wall_map[current_tile.position] = false;
 }
 
-void BaseAlgorithm::sampleDirtSensor()
+void BaseAlgorithm::updateDirtLevel(int dirt_level)
 {
-    current_tile.dirt_level = dirt_sensor.value()->dirtLevel();
+    current_tile.dirt_level = dirt_level;
 
     if (current_tile.dirt_level > 0)
     {
@@ -186,8 +219,34 @@ void BaseAlgorithm::sampleDirtSensor()
     }
 }
 
+void BaseAlgorithm::sampleSurroundingsSensor()
+{
+    Surroundings surroundings = surroundings_sensor->getSurroundings();
+
+    updateWallMap(surroundings.wall_mask);
+    updateDirtLevel(surroundings.dirt_level);
+    battery.amount_left = surroundings.battery_state;
+}
+
+void BaseAlgorithm::mapPosition(const Position& position, bool is_wall, bool is_todo)
+{
+    house.wall_map[position] = is_wall;
+
+    if (!is_wall && is_todo)
+    {
+        house.todo_positions.insert(position);
+    }
+
+    else
+    {
+        house.todo_positions.erase(position);
+    }
+}
+
 bool BaseAlgorithm::enoughStepsLeftToClean()
 {
+    planner_stats.todo_searches++;
+
     std::deque<Direction> path;
     bool is_found = getPathToNearestTodo(current_tile.position, path);
     if (is_found)
@@ -226,6 +285,8 @@ std::size_t BaseAlgorithm::getMaxReachableDistance() const
 
 bool BaseAlgorithm::isCleanedAllReachable()
 {
+    planner_stats.reachability_searches++;
+
     std::deque<Direction> found_path;
     bool is_found = getPathToNearestTodo(kDockingStationPosition, found_path, total_steps_left);
     if (!is_found)
@@ -241,6 +302,32 @@ bool BaseAlgorithm::isCleanedAllReachable()
     return false;
 }
 
+std::size_t BaseAlgorithm::getMaxChargingStays()
+{
+    planner_stats.todo_searches++;
+
+    std::deque<Direction> path;
+    bool is_found = getPathToNearestTodo(kDockingStationPosition, path, total_steps_left);
+    if (!is_found)
+    {
+        return 1;
+    }
+
+    /*
+     * enoughStepsLeftToClean() holds as long as Cleaning Cost < Steps Left,
+     * and each stay decreases Steps Left by 1.
+     * (isCleanedAllReachable() doesn't change meanwhile, since the nearest todo position is found within Steps Left)
+     */
+    std::size_t cleaning_cost = 2 * getPathDistance(path) + 1;
+    if (cleaning_cost >= total_steps_left)
+    {
+        // Kept charging since the nearest todo position is beyond the battery level - re-decide after each stay
+        return 1;
+    }
+
+    return total_steps_left - cleaning_cost;
+}
+
 bool BaseAlgorithm::isValidTargetPath(const std::deque<Direction>& target_path)
 {
     Position position = current_tile.position;
@@ -251,6 +338,7 @@ bool BaseAlgorithm::isValidTargetPath(const std::deque<Direction>& target_path)
         position = Position::computePosition(position, direction);
 
         std::deque<Direction> path_from_target_to_station;
+        planner_stats.validity_searches++;
         bool found_path_to_station = getPathToPosition(position, kDockingStationPosition, path_from_target_to_station, total_steps_left);
         if (!found_path_to_station)
         {
@@ -272,6 +360,8 @@ bool BaseAlgorithm::isValidTargetPath(const std::deque<Direction>& target_path)
 
 Step BaseAlgorithm::decideNextStep()
 {
+    is_charging = false;
+
     std::deque<Direction> path_to_station;
     bool is_found = getPathToStation(path_to_station);
     if (!is_found)
@@ -284,44 +374,50 @@ Step BaseAlgorithm::decideNextStep()
 
     if (shouldFinish(is_cleaned_all_reachable))
     {
-        return Step::Finish;
+        return countDecision(PlannerStats::Decision::Finish, Step::Finish);
     }
 
     if (shouldKeepCharging())
     {
-        return Step::Stay;
+        is_charging = true;
+        return countDecision(PlannerStats::Decision::Charge, Step::Stay);
     }
 
     if (isTooLowBatteryToStay(station_distance) || is_cleaned_all_reachable)
     {
-        return getPathNextStep(path_to_station);
+        return countDecision(PlannerStats::Decision::Return, getPathNextStep(path_to_station));
     }
 
     if (isCurrentPositionDirty())
     {
-        return Step::Stay;
+        return countDecision(PlannerStats::Decision::Clean, Step::Stay);
     }
 
     if (isTooLowBatteryToGetFurther(station_distance))
     {
-        return getPathNextStep(path_to_station);
+        return countDecision(PlannerStats::Decision::TurnBack, getPathNextStep(path_to_station));
     }
 
+    // The searches made by the (derived) algorithm while looking for its next target
+    std::size_t num_searches_before_target = planner_stats.num_searches;
+
     std::deque<Direction> path_to_next_target;
     is_found = getPathToNextTarget(current_tile.position, path_to_next_target);
 
+    planner_stats.target_searches += planner_stats.num_searches - num_searches_before_target;
+
     // If there's no path to a TODO position - go to station
     if (!is_found || !isValidTargetPath(path_to_next_target))
     {
         if (current_tile.position == kDockingStationPosition)
         {
-            return Step::Finish;
+            return countDecision(PlannerStats::Decision::NoTarget, Step::Finish);
         }
 
-        return getPathNextStep(path_to_station);
+        return countDecision(PlannerStats::Decision::NoTarget, getPathNextStep(path_to_station));
     }
 
-    return getPathNextStep(path_to_next_target);
+    return countDecision(PlannerStats::Decision::Target, getPathNextStep(path_to_next_target));
 }
 
 void BaseAlgorithm::move(Step step)
@@ -351,6 +447,7 @@ void BaseAlgorithm::setMaxSteps(std::size_t max_steps)
 void BaseAlgorithm::setWallsSensor(const WallsSensor& walls_sensor)
 {
     this->walls_sensor = &walls_sensor;
+    surroundings_sensor = dynamic_cast<const SurroundingsSensor*>(&walls_sensor);
 }
 
 void BaseAlgorithm::setDirtSensor(const DirtSensor& dirt_sensor)
@@ -376,3 +473,46 @@ Step BaseAlgorithm::nextStep()
 
     return step;
 }
+
+MacroStep BaseAlgorithm::nextMacroStep()
+{
+    assertAllInitialied();
+
+    sampleSensors();
+
+    Step step = decideNextStep();
+
+    last_macro_step = MacroStep();
+
+    if (is_charging)
+    {
+        last_macro_step.kind = MacroStep::Kind::StayUntilBattery;
+        last_macro_step.target_battery = battery.full_capacity;
+        last_macro_step.max_stays = getMaxChargingStays();
+    }
+
+    else
+    {
+        // A view of a member - so a single step costs no allocation
+        last_step = step;
+        last_macro_step.steps = std::span<const Step>(&last_step, 1);
+    }
+
+    return last_macro_step;
+}
+
+void BaseAlgorithm::onMacroStepDone(std::size_t num_steps_taken)
+{
+    for (std::size_t i = 0; i < num_steps_taken; i++)
+    {
+        if (MacroStep::Kind::StayUntilBattery == last_macro_step.kind)
+        {
+            move(Step::Stay);
+        }
+
+        else
+        {
+            move(last_macro_step.steps[i]);
+        }
+    }
+}
@@ -10,6 +10,9 @@
 #include <unordered_map>
 
 #include "common/abstract_algorithm.h"
+#include "common/macro_step_algorithm.h"
+#include "common/planner_stats_algorithm.h"
+#include "common/surroundings_sensor.h"
 #include "common/battery_meter.h"
 #include "common/dirt_sensor.h"
 #include "common/wall_sensor.h"
@@ -28,8 +31,10 @@
  * It uses a path tree to store the paths explored during navigation.
  *
  * The class provides methods for suggesting the next step and moving the vacuum cleaner in a specific direction.
+ * While charging at the docking station, it suggests all the charging stays at once (as a macro step).
+ * It counts its path searches and decisions (see PlannerStats).
  */
-class BaseAlgorithm : public AbstractAlgorithm
+class BaseAlgorithm : public AbstractAlgorithm, public MacroStepAlgorithm, public PlannerStatsAlgorithm
 {
     inline static const Position kDockingStationPosition = {0,0};       // Docking Station (relative) position.
 
@@ -57,10 +62,16 @@ class BaseAlgorithm : public AbstractAlgorithm
 
     std::optional<std::size_t> max_steps;               // Maximal allowed steps to take.
     std::size_t total_steps_left;                       // Number of allowed steps left.
+    MacroStep last_macro_step;                          // The last suggested macro step (applied on its notification).
+    Step last_step = Step::Stay;                        // The step of the last suggested (Steps kind) macro step.
+    bool is_charging = false;                           // Whether or not the last decided step is a charging stay.
+    std::size_t last_path_tree_size = 0;                // The number of nodes of the last path search's tree.
+    PlannerStats planner_stats;                         // The planner's work so far.
 
     std::optional<const BatteryMeter*> battery_meter;   // Pointer to the battery meter.
     std::optional<const DirtSensor*> dirt_sensor;       // Pointer to the dirt sensor.
     std::optional<const WallsSensor*> walls_sensor;     // Pointer to the walls sensor.
+    const SurroundingsSensor* surroundings_sensor = nullptr; // The walls sensor as a surroundings sensor (if it implements one).
 
     /**
      * @brief Checks if the algorithm is fully initialized.
@@ -95,7 +106,7 @@ class BaseAlgorithm : public AbstractAlgorithm
     std::optional<std::size_t> buildPathTree(PathTree& path_tree,
                                              std::size_t max_depth,
                                              std::size_t start_index,
-                                             std::function<bool(const Position&)> const & found_criteria) const;
+                                             std::function<bool(const Position&)> const & found_criteria);
 
     /**
      * @brief Calculates the distance of a path.
@@ -162,10 +173,25 @@ class BaseAlgorithm : public AbstractAlgorithm
      */
     void sampleWallSensor();
 
+    /**
+     * @brief Maps the positions adjacent to the current position by a wall mask (see SurroundingsSensor).
+     */
+    void updateWallMap(std::uint8_t wall_mask);
+
+    /**
+     * @brief Updates the current position's dirt level.
+     */
+    void updateDirtLevel(int dirt_level);
+
     /**
      * @brief Samples the dirt sensor to detect the dirt level at the current position.
      */
-    void sampleDirtSensor();
+    void sampleDirtSensor() { updateDirtLevel(dirt_sensor.value()->dirtLevel()); }
+
+    /**
+     * @brief Samples all sensors at once by the surroundings sensor.
+     */
+    void sampleSurroundingsSensor();
 
     /**
      * @brief Samples the battery meter to get the amount of battery left.
@@ -176,9 +202,16 @@ class BaseAlgorithm : public AbstractAlgorithm
      * @brief Gets the information from the sensors.
      *
      * This method gets the information from the sensors and updates the relevant data members.
+     * A surroundings sensor (if available) is sampled instead of the separate sensors.
      */
     void sampleSensors()
     {
+        if (nullptr != surroundings_sensor)
+        {
+            sampleSurroundingsSensor();
+            return;
+        }
+
         sampleWallSensor();
         sampleDirtSensor();
         sampleBatteryMeter();
@@ -207,13 +240,6 @@ class BaseAlgorithm : public AbstractAlgorithm
      */
     std::size_t getMaxReachableDistance() const;
 
-    /**
-     * @brief Checks if all reachable positions are cleaned.
-     * 
-     * @return True if all reachable positions were cleaned, false otherwise.
-     */
-    bool isCleanedAllReachable();
-
     /**
      * @brief Checks if the algorithm should finish.
      *
@@ -242,6 +268,17 @@ class BaseAlgorithm : public AbstractAlgorithm
      */
     bool shouldKeepCharging() { return isAtDockingStation() && !isBatteryFull() && enoughStepsLeftToClean(); }
 
+    /**
+     * @brief Computes how many charging stays in a row decideNextStep() would suggest, if the battery doesn't fill up.
+     *
+     * While charging, the only changing readings are the battery level and the number of steps left - so charging
+     * goes on until the battery is full, or until there are just enough steps left to clean the nearest todo position.
+     * Must be called right after decideNextStep() decided to keep charging.
+     *
+     * @return The number of charging stays (at least 1).
+     */
+    std::size_t getMaxChargingStays();
+
     /**
      * @brief Checks if the algorithm must return to station, and cannot stay or get further.
      * 
@@ -283,6 +320,19 @@ class BaseAlgorithm : public AbstractAlgorithm
      */
     Step decideNextStep();
 
+    /**
+     * @brief Counts a decision of decideNextStep() (see PlannerStats::decisions).
+     *
+     * @param decision The kind of the decision.
+     * @param step The decided step.
+     * @return The decided step.
+     */
+    Step countDecision(PlannerStats::Decision decision, Step step)
+    {
+        planner_stats.decisions[static_cast<std::size_t>(decision)]++;
+        return step;
+    }
+
     /**
      * @brief Decreases the algorithm's internal `total_steps_left` counter, while avoiding out of range values.
      * 
@@ -324,6 +374,27 @@ protected:
 
     bool isToDoPosition(const Position& position) const { return house.todo_positions.contains(position); }
 
+    /**
+     * @brief Maps a position into the house model directly, as if it was sensed (e.g. for benchmarking path searches on a known map).
+     *
+     * @param position The (relative) position to map.
+     * @param is_wall Whether or not the position is a wall.
+     * @param is_todo Whether or not the position should be visited (ignored for walls).
+     */
+    void mapPosition(const Position& position, bool is_wall, bool is_todo);
+
+    /**
+     * @brief Gets the number of nodes in the path tree of the last path search (the positions it expanded).
+     */
+    std::size_t getLastPathTreeSize() const { return last_path_tree_size; }
+
+    /**
+     * @brief Checks if all reachable positions are cleaned.
+     * 
+     * @return True if all reachable positions were cleaned, false otherwise.
+     */
+    bool isCleanedAllReachable();
+
     std::size_t getMaxStepsLeftTillReturnToStation() const { return std::min(battery.amount_left, total_steps_left); }
 
     /**
@@ -393,6 +464,8 @@ public:
     /**
      * @brief Set the walls sensor for the algorithm.
      *
+     * If the walls sensor is also a SurroundingsSensor, all sensors are sampled through it.
+     *
      * @param wallsSensor The walls sensor to use.
      */
     void setWallsSensor(const WallsSensor&) override;
@@ -417,6 +490,27 @@ public:
      * @return The next step to take.
      */
     Step nextStep() override;
+
+    /**
+     * @brief Get the next macro step to take - all charging stays at once, or a single step otherwise.
+     *
+     * @return The next macro step to take.
+     */
+    MacroStep nextMacroStep() override;
+
+    /**
+     * @brief Applies the steps taken out of the last macro step to the algorithm's state.
+     *
+     * @param num_steps_taken The number of steps taken.
+     */
+    void onMacroStepDone(std::size_t num_steps_taken) override;
+
+    /**
+     * @brief Get the planner's work so far.
+     *
+     * @return The planner stats accumulated since the algorithm was created.
+     */
+    PlannerStats getPlannerStats() const override { return planner_stats; }
 };
 
 #endif /* BASE_ALGORITHM_H_ */
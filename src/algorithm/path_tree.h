@@ -138,6 +138,13 @@ public:
      */
     std::size_t getScore(std::size_t node_index) const { return safeNodeAccess(node_index).score; }
 
+    /**
+     * @brief Gets the number of nodes in the path tree.
+     * 
+     * @return The number of nodes in the path tree.
+     */
+    std::size_t getNumNodes() const { return node_pool.size(); }
+
     /**
      * @brief Registers an end node index in the path tree.
      * 
@@ -0,0 +1,125 @@
+#include "batch_runner.h"
+
+#include "simulator/batch_simulator.h"
+
+#include "output_handler.h"
+#include "memory_tracker.h"
+#include "trace_recorder.h"
+
+#include <algorithm>
+#include <exception>
+#include <atomic>
+#include <thread>
+
+BatchRunner::BatchRunner(const std::vector<Job>& jobs, std::size_t num_threads, std::size_t batch_size, bool summary_only)
+    : jobs(jobs),
+      num_threads(std::max<std::size_t>(1, num_threads)),
+      summary_only(summary_only),
+      results(jobs.size())
+{
+    batch_size = std::max<std::size_t>(1, batch_size);
+
+    for (std::size_t i = 0; i < jobs.size(); i++)
+    {
+        bool is_same_batch = !batches.empty()
+                             && batches.back().num_jobs < batch_size
+                             && jobs[batches.back().first_job_index].algorithm_name == jobs[i].algorithm_name;
+
+        if (is_same_batch)
+        {
+            batches.back().num_jobs++;
+        }
+
+        else
+        {
+            batches.push_back({.first_job_index = i, .num_jobs = 1});
+        }
+    }
+}
+
+void BatchRunner::runBatch(const Batch& batch)
+{
+    std::vector<const HouseFile*> house_files;
+    for (std::size_t i = 0; i < batch.num_jobs; i++)
+    {
+        house_files.push_back(jobs[batch.first_job_index + i].house_file);
+    }
+
+    const Job& first_job = jobs[batch.first_job_index];
+    TraceRecorder::ScopedSpan batch_span("task", "batch", TraceRecorder::formatArgument("algorithm", first_job.algorithm_name) + "," + TraceRecorder::formatArgument("houses", batch.num_jobs));
+
+    MemoryTracker::resetThreadUsage();
+
+    std::unique_ptr<BatchSimulator> batch_simulator;
+    std::string batch_error;
+
+    try
+    {
+        batch_simulator = std::make_unique<BatchSimulator>(house_files, first_job.algorithm_factory);
+        batch_simulator->run();
+    }
+
+    catch (const std::exception& exception)
+    {
+        // Failed to set up the batch's algorithms - all of its jobs are failed
+        batch_simulator.reset();
+        batch_error = exception.what();
+    }
+
+    std::size_t peak_memory_bytes = static_cast<std::size_t>(MemoryTracker::getThreadUsage().peak_bytes.load(std::memory_order_relaxed));
+
+    for (std::size_t lane = 0; lane < batch.num_jobs; lane++)
+    {
+        const Job& job = jobs[batch.first_job_index + lane];
+        JobResult& result = results[batch.first_job_index + lane];
+
+        result.performance.time_budget = std::chrono::milliseconds(job.house_file->max_steps);
+        result.performance.peak_memory_bytes = peak_memory_bytes;
+
+        if (nullptr == batch_simulator)
+        {
+            result.score = Simulator(*job.house_file).getTimeoutScore();
+            result.algorithm_error = formatJobError(job, batch_error);
+            continue;
+        }
+
+        const SimulationStatistics& statistics = batch_simulator->getSimulationStatistics(lane);
+
+        result.score = batch_simulator->getScore(lane);
+        result.algorithm_error = batch_simulator->getAlgorithmError(lane).empty() ? "" : formatJobError(job, batch_simulator->getAlgorithmError(lane));
+        result.performance.wall_time = batch_simulator->getAlgorithmTime(lane);
+        result.performance.cpu_time = batch_simulator->getAlgorithmCpuTime(lane);
+        result.performance.num_steps = statistics.num_steps_taken;
+        result.performance.is_timeout = batch_simulator->isTimedOut(lane);
+        result.performance.planner_stats = batch_simulator->getPlannerStats(lane);
+
+        if (!summary_only)
+        {
+            OutputHandler::exportStatistics(job.algorithm_name, job.house_file->name, statistics, result.score);
+        }
+    }
+}
+
+void BatchRunner::run()
+{
+    std::atomic<std::size_t> next_batch_index = 0;
+
+    auto runBatches = [this, &next_batch_index]()
+    {
+        for (std::size_t i = next_batch_index++; i < batches.size(); i = next_batch_index++)
+        {
+            runBatch(batches[i]);
+        }
+    };
+
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 1; i < std::min(num_threads, batches.size()); i++)
+    {
+        threads.emplace_back([&runBatches]() {
+            TraceRecorder::setThreadName("batch worker");
+            runBatches();
+        });
+    }
+
+    runBatches();
+}
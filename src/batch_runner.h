@@ -0,0 +1,65 @@
+#ifndef BATCH_RUNNER_H_
+#define BATCH_RUNNER_H_
+
+#include "job.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief The BatchRunner class simulates jobs in lockstep batches (see BatchSimulator), over a fixed number of threads.
+ *
+ * Consecutive jobs of the same algorithm are grouped into batches of up to a fixed number of houses - each batch is
+ * run by a single thread, with no per-simulation Task, timer or thread handoff. It's meant for cheap algorithms on
+ * many small houses, where these fixed costs dominate the simulations themselves.
+ *
+ * A job's time budget is charged with the time of its own algorithm calls only (which is reported as both its wall-clock
+ * and CPU time), and its peak memory is its whole batch's.
+ */
+class BatchRunner
+{
+    /**
+     * @brief A batch of consecutive jobs (of the same algorithm).
+     */
+    struct Batch
+    {
+        std::size_t first_job_index;
+        std::size_t num_jobs;
+    };
+
+    const std::vector<Job>& jobs;
+    const std::size_t num_threads;
+    const bool summary_only;
+
+    std::vector<Batch> batches;
+    std::vector<JobResult> results;
+
+    /**
+     * @brief Simulates a single batch into its jobs' results.
+     */
+    void runBatch(const Batch& batch);
+
+public:
+    /**
+     * @param jobs The jobs to be simulated (must outlive the runner).
+     * @param num_threads The number of batch running threads.
+     * @param batch_size The maximal number of jobs in a batch.
+     * @param summary_only Whether to skip exporting the jobs' statistics (output) files.
+     */
+    BatchRunner(const std::vector<Job>& jobs, std::size_t num_threads, std::size_t batch_size, bool summary_only);
+
+    BatchRunner(const BatchRunner& batch_runner) = delete;
+    BatchRunner& operator=(const BatchRunner& batch_runner) = delete;
+
+    /**
+     * @brief Runs all jobs. Returns only after all batches are finished.
+     */
+    void run();
+
+    /**
+     * @brief Returns the result of a given job (valid after run() returned).
+     */
+    const JobResult& getResult(std::size_t job_index) const { return results.at(job_index); }
+};
+
+#endif /* BATCH_RUNNER_H_ */
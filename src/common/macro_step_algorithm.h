@@ -0,0 +1,63 @@
+#ifndef MACRO_STEP_ALGORITHM_H_
+#define MACRO_STEP_ALGORITHM_H_
+
+#include <cstddef>
+#include <span>
+
+#include "enums.h"
+
+/**
+ * @brief The MacroStep struct represents a run of steps planned by an algorithm at once.
+ */
+struct MacroStep
+{
+    /**
+     * @brief The different kinds of macro steps.
+     */
+    enum class Kind
+    {
+        Steps,              // Take the given steps, in order.
+        StayUntilBattery    // Stay (charge at the docking station) until the battery reaches a target level.
+    };
+
+    Kind kind = Kind::Steps;
+    std::span<const Step> steps;        // The steps to be taken (Steps kind only), owned by the algorithm until onMacroStepDone().
+    std::size_t target_battery = 0;     // Stop staying once the battery meter reads at least this level (StayUntilBattery kind only).
+    std::size_t max_stays = 0;          // The maximal number of stays to be taken (StayUntilBattery kind only).
+};
+
+/**
+ * @brief The MacroStepAlgorithm class is an optional interface for algorithms which can plan several steps at once.
+ *
+ * An algorithm implementing this interface (alongside AbstractAlgorithm) is asked for macro steps instead of single
+ * steps, and the simulator takes them without calling back into the algorithm - so the algorithm must only plan steps
+ * whose sensor readings it doesn't need. A macro step is interrupted early when the simulation ends (finished, dead or
+ * out of steps), when a StayUntilBattery target is reached, or when the caller's step budget is exhausted.
+ */
+class MacroStepAlgorithm
+{
+public:
+    /**
+     * @brief Virtual destructor for the MacroStepAlgorithm class.
+     */
+    virtual ~MacroStepAlgorithm() {}
+
+    /**
+     * @brief Get the next macro step to take (replaces nextStep()).
+     *
+     * The first step of a macro step is always taken (unless the simulation is out of steps).
+     * The steps it refers to must remain valid until the following onMacroStepDone() call.
+     *
+     * @return The next macro step to take (must contain at least one step).
+     */
+    virtual MacroStep nextMacroStep() = 0;
+
+    /**
+     * @brief Notifies the algorithm of how many steps of its last macro step were actually taken.
+     *
+     * @param num_steps_taken The number of steps taken (a prefix of the macro step).
+     */
+    virtual void onMacroStepDone(std::size_t num_steps_taken) = 0;
+};
+
+#endif /* MACRO_STEP_ALGORITHM_H_ */
@@ -0,0 +1,62 @@
+#ifndef PLANNER_STATS_ALGORITHM_H_
+#define PLANNER_STATS_ALGORITHM_H_
+
+#include <array>
+#include <cstddef>
+
+/**
+ * @brief The PlannerStats struct represents the work done by an algorithm's path planner during a simulation.
+ */
+struct PlannerStats
+{
+    /**
+     * @brief The different decisions of a step (which branch of the planner decided it).
+     */
+    enum class Decision
+    {
+        Finish,             // Finished cleaning (or out of steps).
+        Charge,             // Kept charging at the docking station.
+        Return,             // Returned to the station (too low battery to stay, or nothing reachable left to clean).
+        Clean,              // Stayed to clean the current (dirty) position.
+        TurnBack,           // Returned to the station (too low battery to get any further).
+        NoTarget,           // Returned to the station (or finished) since no valid target was found.
+        Target              // Took a step towards the next target.
+    };
+
+    static constexpr const std::size_t kNumDecisions = static_cast<std::size_t>(Decision::Target) + 1;
+
+    std::size_t num_searches = 0;                   // Path searches (BFS) of any kind.
+    std::size_t station_searches = 0;               // Searches of a path back to the docking station.
+    std::size_t todo_searches = 0;                  // Searches of a path to the nearest todo position (cleaning cost checks).
+    std::size_t reachability_searches = 0;          // Searches checking whether all reachable positions are cleaned.
+    std::size_t validity_searches = 0;              // Searches of a path back to the station from along a target path.
+    std::size_t target_searches = 0;                // Searches of a path to the next target.
+    std::size_t nodes_expanded = 0;                 // Path tree nodes whose children were explored (over all searches).
+    std::size_t path_tree_nodes = 0;                // Path tree nodes created (over all searches).
+    std::size_t peak_path_tree_nodes = 0;           // Nodes in the largest path tree (its node pool size).
+    std::array<std::size_t, kNumDecisions> decisions{}; // The number of decisions of each kind (a macro step is a single decision).
+};
+
+/**
+ * @brief The PlannerStatsAlgorithm class is an optional interface for algorithms which report their planner's work.
+ *
+ * An algorithm implementing this interface (alongside AbstractAlgorithm) has its planner stats collected once its
+ * simulation is over (and reported per algorithm - house pair).
+ */
+class PlannerStatsAlgorithm
+{
+public:
+    /**
+     * @brief Virtual destructor for the PlannerStatsAlgorithm class.
+     */
+    virtual ~PlannerStatsAlgorithm() {}
+
+    /**
+     * @brief Get the planner's work so far (must not be called while the algorithm is deciding a step).
+     *
+     * @return The planner stats accumulated since the algorithm was created.
+     */
+    virtual PlannerStats getPlannerStats() const = 0;
+};
+
+#endif /* PLANNER_STATS_ALGORITHM_H_ */
@@ -0,0 +1,57 @@
+#ifndef SURROUNDINGS_SENSOR_H_
+#define SURROUNDINGS_SENSOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "enums.h"
+
+/**
+ * @brief The Surroundings struct represents all sensor readings at the robot's current position.
+ */
+struct Surroundings
+{
+    std::uint8_t wall_mask;             // A wall bit per direction (see SurroundingsSensor::getWallBit()).
+    int dirt_level;                     // The dirt level at the current position.
+    std::size_t battery_state;          // The current amount of remaining battery capacity (in steps).
+};
+
+/**
+ * @brief The SurroundingsSensor class is an optional interface for sampling all sensors in a single call.
+ *
+ * A walls sensor which also implements this interface is sampled through it instead of the separate
+ * WallsSensor, DirtSensor and BatteryMeter calls (its readings must match theirs).
+ */
+class SurroundingsSensor
+{
+    public:
+        /**
+         * @brief Virtual destructor for the SurroundingsSensor class.
+         */
+        virtual ~SurroundingsSensor() {}
+
+        /**
+         * @brief Gets the bit of a given direction in the wall mask (North, East, South and West are bits 0 to 3).
+         */
+        static constexpr std::uint8_t getWallBit(Direction direction)
+        {
+            return static_cast<std::uint8_t>(1u << static_cast<unsigned int>(direction));
+        }
+
+        /**
+         * @brief Checks if a wall mask has a wall in the specified direction.
+         */
+        static constexpr bool isWall(std::uint8_t wall_mask, Direction direction)
+        {
+            return 0 != (wall_mask & getWallBit(direction));
+        }
+
+        /**
+         * @brief Samples the walls around the current position, its dirt level and the battery state at once.
+         *
+         * @return The current sensor readings.
+         */
+        virtual Surroundings getSurroundings() const = 0;
+};
+
+#endif /* SURROUNDINGS_SENSOR_H_ */
@@ -0,0 +1,49 @@
+#ifndef TRACEPOINTS_H_
+#define TRACEPOINTS_H_
+
+/**
+ * USDT (user statically defined tracing) probes of the `vacuum` provider, for live diagnosis by `perf` / `bpftrace`.
+ *
+ * When <sys/sdt.h> is available (e.g. by the systemtap-sdt-dev package), each probe is a single `nop` instruction
+ * (plus an ELF note), which is patched into a breakpoint only while a tracer is attached to it. The tracer reads the
+ * arguments from wherever they already are (registers / stack) - but they're computed even while no tracer is
+ * attached, so they must be cheap (e.g. fields, not formatted strings).
+ * Otherwise, the probes compile to nothing (their arguments are neither evaluated nor reported as unused).
+ *
+ * Probes (a double underscore is a dash in the probe name, e.g. `usdt:./bin/myrobot:vacuum:task-start`):
+ * - task__start(algorithm, house)                      - A task's worker thread started simulating its pair.
+ * - task__end(algorithm, house, score, num_steps)      - A task finished (gracefully, or by an error), on its worker thread.
+ * - task__timeout(algorithm, house, score)             - A task timed out, on the timeouts thread.
+ * - step(step_index, step, battery_level)              - The simulator is applying a step (`step` is a Step value, its index is zero-based).
+ * - search__begin(max_depth)                           - The algorithm's planner started a path search.
+ * - search__end(nodes_expanded, path_tree_nodes, is_found) - The path search ended.
+ *
+ * Names are `const char*` arguments. The step and search probes fire on the worker thread, so they can be
+ * attributed to their pair by the thread id of its task__start probe.
+ */
+
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define VACUUM_HAS_TRACEPOINTS 1
+#endif
+#endif
+
+#ifdef VACUUM_HAS_TRACEPOINTS
+
+#define VACUUM_TRACEPOINT1(name, arg1) DTRACE_PROBE1(vacuum, name, arg1)
+#define VACUUM_TRACEPOINT2(name, arg1, arg2) DTRACE_PROBE2(vacuum, name, arg1, arg2)
+#define VACUUM_TRACEPOINT3(name, arg1, arg2, arg3) DTRACE_PROBE3(vacuum, name, arg1, arg2, arg3)
+#define VACUUM_TRACEPOINT4(name, arg1, arg2, arg3, arg4) DTRACE_PROBE4(vacuum, name, arg1, arg2, arg3, arg4)
+
+#else
+
+// `sizeof` keeps the arguments used, without evaluating them
+#define VACUUM_TRACEPOINT1(name, arg1) static_cast<void>(sizeof(arg1))
+#define VACUUM_TRACEPOINT2(name, arg1, arg2) static_cast<void>(sizeof(arg1) + sizeof(arg2))
+#define VACUUM_TRACEPOINT3(name, arg1, arg2, arg3) static_cast<void>(sizeof(arg1) + sizeof(arg2) + sizeof(arg3))
+#define VACUUM_TRACEPOINT4(name, arg1, arg2, arg3, arg4) static_cast<void>(sizeof(arg1) + sizeof(arg2) + sizeof(arg3) + sizeof(arg4))
+
+#endif
+
+#endif /* TRACEPOINTS_H_ */
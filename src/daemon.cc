@@ -0,0 +1,394 @@
+#include "daemon.h"
+
+#include "common/AlgorithmRegistrar.h"
+
+#include "output_handler.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    std::set<std::string> splitList(const std::string& list, char separator)
+    {
+        std::set<std::string> items;
+        std::istringstream list_stream(list);
+        std::string item;
+
+        while (std::getline(list_stream, item, separator))
+        {
+            if (!item.empty())
+            {
+                items.insert(item);
+            }
+        }
+
+        return items;
+    }
+
+    bool sendAll(int connection_socket, const std::string& data)
+    {
+        std::size_t sent_size = 0;
+        while (sent_size < data.size())
+        {
+            // MSG_NOSIGNAL - a disconnected client mustn't terminate the daemon (by SIGPIPE).
+            ssize_t result = send(connection_socket, data.data() + sent_size, data.size() - sent_size, MSG_NOSIGNAL);
+            if (result < 0)
+            {
+                return false;
+            }
+
+            sent_size += static_cast<std::size_t>(result);
+        }
+
+        return true;
+    }
+
+    bool isSelected(const std::optional<std::set<std::string>>& selection, const std::string& name)
+    {
+        return !selection.has_value() || selection->contains(name);
+    }
+}
+
+Daemon::Daemon(const Arguments& arguments)
+    : arguments(arguments),
+      socket_path(arguments.daemon_socket.value()),
+      listen_socket(-1),
+      algorithm_generation(0),
+      is_running(false)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error("Daemon socket path is too long: " + socket_path);
+    }
+
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    listen_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_socket < 0)
+    {
+        throw std::runtime_error("Daemon couldn't create a socket: " + std::string(std::strerror(errno)));
+    }
+
+    // Remove a stale socket left by a previous daemon
+    unlink(socket_path.c_str());
+
+    if (0 != bind(listen_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) ||
+        0 != listen(listen_socket, kListenBacklog))
+    {
+        std::string error_message = std::strerror(errno);
+        close(listen_socket);
+        throw std::runtime_error("Daemon couldn't listen on " + socket_path + ": " + error_message);
+    }
+}
+
+Daemon::~Daemon()
+{
+    close(listen_socket);
+    unlink(socket_path.c_str());
+
+    AlgorithmRegistrar::getAlgorithmRegistrar().clear();
+    InputHandler::closeAlgorithms(algorithm_handles);
+}
+
+void Daemon::refreshHouses()
+{
+    std::vector<std::filesystem::path> house_paths;
+    InputHandler::findHouses(arguments.house_path, house_paths);
+
+    std::set<std::filesystem::path> found_paths(house_paths.begin(), house_paths.end());
+    std::erase_if(houses, [&found_paths](const auto& cached_house) { return !found_paths.contains(cached_house.first); });
+
+    for (const auto& house_path : house_paths)
+    {
+        std::filesystem::file_time_type modification_time = std::filesystem::last_write_time(house_path);
+
+        auto cached_house = houses.find(house_path);
+        if (houses.end() != cached_house && modification_time == cached_house->second.modification_time)
+        {
+            continue;
+        }
+
+        CachedHouse& house = houses[house_path];
+        house.modification_time = modification_time;
+        house.house_file.emplace();
+        house.error_message.clear();
+
+        try
+        {
+            Deserializer::readHouseFile(house_path, house.house_file.value());
+        }
+
+        catch (const std::exception& exception)
+        {
+            house.house_file.reset();
+            house.error_message = exception.what();
+        }
+    }
+}
+
+void Daemon::refreshAlgorithms()
+{
+    std::vector<std::filesystem::path> algorithm_paths;
+    InputHandler::findAlgorithms(arguments.algorithm_path, algorithm_paths);
+
+    std::map<std::filesystem::path, std::filesystem::file_time_type> modification_times;
+    for (const auto& algorithm_path : algorithm_paths)
+    {
+        modification_times[algorithm_path] = std::filesystem::last_write_time(algorithm_path);
+    }
+
+    if (0 != algorithm_generation && modification_times == algorithm_modification_times)
+    {
+        return;
+    }
+
+    // The registered factories live in the algorithm files - so they must be dropped before the files are closed.
+    AlgorithmRegistrar::getAlgorithmRegistrar().clear();
+    InputHandler::closeAlgorithms(algorithm_handles);
+    algorithm_handles.clear();
+
+    algorithm_generation++;
+    std::filesystem::path shadow_directory = std::filesystem::temp_directory_path() /
+        (kShadowDirectoryPrefix + std::to_string(getpid()) + "-" + std::to_string(algorithm_generation));
+
+    std::filesystem::create_directories(shadow_directory);
+    for (const auto& algorithm_path : algorithm_paths)
+    {
+        std::filesystem::copy_file(algorithm_path, shadow_directory / algorithm_path.filename());
+    }
+
+    // Once dlopen()ed, the copies are no longer needed on disk
+    InputHandler::openAlgorithms(shadow_directory.string(), algorithm_handles);
+    std::filesystem::remove_all(shadow_directory);
+
+    algorithm_modification_times = std::move(modification_times);
+}
+
+Daemon::JobRequest Daemon::parseRequest(const std::string& request_line)
+{
+    std::istringstream request_stream(request_line);
+    std::string command;
+    request_stream >> command;
+
+    if (kRunCommand != command)
+    {
+        throw std::invalid_argument("Unknown command: " + command);
+    }
+
+    JobRequest request;
+    std::string field;
+
+    while (request_stream >> field)
+    {
+        if (field.starts_with(kHousesField))
+        {
+            request.house_names = splitList(field.substr(kHousesField.size()), kListSeparator);
+        }
+
+        else if (field.starts_with(kAlgorithmsField))
+        {
+            request.algorithm_names = splitList(field.substr(kAlgorithmsField.size()), kListSeparator);
+        }
+
+        else
+        {
+            throw std::invalid_argument("Unknown field: " + field);
+        }
+    }
+
+    return request;
+}
+
+void Daemon::runJob(const JobRequest& request, const ReplyWriter& writeReply)
+{
+    refreshAlgorithms();
+    refreshHouses();
+
+    std::set<std::string> found_house_names;
+    std::set<std::string> found_algorithm_names;
+    std::vector<const HouseFile*> house_files;
+
+    for (const auto& [house_path, house] : houses)
+    {
+        std::string house_name = house_path.stem().string();
+        if (!isSelected(request.house_names, house_name))
+        {
+            continue;
+        }
+
+        found_house_names.insert(house_name);
+
+        if (house.house_file.has_value())
+        {
+            house_files.push_back(&house.house_file.value());
+        }
+
+        else
+        {
+            writeReply(kErrorReply + kListSeparator + house_name + kListSeparator + house.error_message + '\n');
+        }
+    }
+
+    std::vector<Job> jobs;
+
+    const AlgorithmRegistrar& registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+    for (auto algorithm = registrar.begin(); algorithm != registrar.end(); algorithm++)
+    {
+        if (!isSelected(request.algorithm_names, algorithm->name()))
+        {
+            continue;
+        }
+
+        found_algorithm_names.insert(algorithm->name());
+
+        for (const HouseFile* house_file : house_files)
+        {
+            jobs.push_back({
+                .algorithm_name = algorithm->name(),
+                .algorithm_factory = [algorithm]() { return algorithm->create(); },
+                .house_file = house_file,
+                .cycle_check_interval = arguments.cycle_check_interval
+            });
+        }
+    }
+
+    auto reportMissing = [&writeReply](const std::optional<std::set<std::string>>& requested_names,
+                                  const std::set<std::string>& found_names,
+                                  const std::string& module_type)
+    {
+        if (!requested_names.has_value())
+        {
+            return;
+        }
+
+        for (const auto& name : requested_names.value())
+        {
+            if (!found_names.contains(name))
+            {
+                writeReply(kErrorReply + kListSeparator + name + kListSeparator + "No such " + module_type + '\n');
+            }
+        }
+    };
+
+    reportMissing(request.house_names, found_house_names, "house");
+    reportMissing(request.algorithm_names, found_algorithm_names, "algorithm");
+
+    TimeoutPolicy timeout_policy = {
+        .is_cpu_time = arguments.cpu_timeout,
+        .wall_ceiling_factor = arguments.wall_ceiling_factor
+    };
+
+    // Each pair is replied as soon as it's done - so the client doesn't wait for the slowest pair to see the others.
+    auto replyResult = [&jobs, &writeReply](std::size_t job_index, const JobResult& result)
+    {
+        const Job& job = jobs[job_index];
+
+        writeReply(job.algorithm_name + kListSeparator + job.house_file->name + kListSeparator + std::to_string(result.score) + '\n');
+
+        if (!result.algorithm_error.empty())
+        {
+            writeReply(kErrorReply + kListSeparator + job.algorithm_name + kListSeparator + result.algorithm_error + '\n');
+        }
+    };
+
+    // Workers only report back - statistics files aren't written by the daemon.
+    WorkerPool worker_pool(jobs, arguments.num_threads, timeout_policy, true, replyResult);
+    worker_pool.run();
+}
+
+void Daemon::handleRequest(const std::string& request_line, const ReplyWriter& writeReply)
+{
+    try
+    {
+        if (kShutdownCommand == request_line)
+        {
+            is_running = false;
+        }
+
+        else
+        {
+            runJob(parseRequest(request_line), writeReply);
+        }
+    }
+
+    catch (const std::exception& exception)
+    {
+        writeReply(kErrorReply + kListSeparator + "Daemon" + kListSeparator + exception.what() + '\n');
+    }
+
+    writeReply(kEndReply + '\n');
+}
+
+void Daemon::serveConnection(int connection_socket)
+{
+    std::string buffered_input;
+    char read_buffer[4096];
+
+    while (is_running)
+    {
+        ssize_t read_size = recv(connection_socket, read_buffer, sizeof(read_buffer), 0);
+        if (read_size <= 0)
+        {
+            return;
+        }
+
+        buffered_input.append(read_buffer, static_cast<std::size_t>(read_size));
+
+        std::size_t line_end;
+        while (is_running && std::string::npos != (line_end = buffered_input.find('\n')))
+        {
+            std::string request_line = buffered_input.substr(0, line_end);
+            buffered_input.erase(0, line_end + 1);
+
+            if (!request_line.empty() && '\r' == request_line.back())
+            {
+                request_line.pop_back();
+            }
+
+            // A client which disconnected mid-job isn't replied to anymore - but its job still runs to its end
+            bool is_connected = true;
+            handleRequest(request_line, [connection_socket, &is_connected](const std::string& reply_line) {
+                is_connected = is_connected && sendAll(connection_socket, reply_line);
+            });
+
+            if (!is_connected)
+            {
+                return;
+            }
+        }
+    }
+}
+
+void Daemon::serve()
+{
+    is_running = true;
+
+    OutputHandler::printMessage("Serving on " + socket_path);
+
+    while (is_running)
+    {
+        int connection_socket = accept(listen_socket, nullptr, nullptr);
+        if (connection_socket < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            throw std::runtime_error("Daemon couldn't accept a connection: " + std::string(std::strerror(errno)));
+        }
+
+        serveConnection(connection_socket);
+        close(connection_socket);
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef DAEMON_H_
+#define DAEMON_H_
+
+#include "input_handler.h"
+#include "worker_pool.h"
+
+#include "simulator/deserializer.h"
+
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+/**
+ * @brief The Daemon class serves simulation jobs on a Unix domain socket, keeping houses and algorithms loaded between jobs.
+ *
+ * The protocol is line based. Each request is a single line:
+ *  - `run [houses=<house>,...] [algos=<algorithm>,...]` - simulates the given houses and algorithms (all of them when omitted).
+ *    Replies with an `<algorithm>,<house>,<score>` line per pair, an `ERROR,<module>,<message>` line per error, and an `END` line.
+ *    Each pair's line is sent as soon as the pair is done (so pairs are replied in the order they finish).
+ *  - `shutdown` - replies with an `END` line and stops the daemon.
+ *
+ * Before each job, houses whose file was added, removed or modified (by mtime) are re-read - unchanged houses are reused.
+ * Since the registrar can't unregister a single algorithm, a change in any algorithm file reloads all algorithms.
+ *
+ * Jobs are always simulated in isolated worker processes (see WorkerPool): a timed out thread can't be stopped,
+ * and a long-lived process can't afford to leave it running over memory freed after its job.
+ */
+class Daemon
+{
+    inline static const std::string kRunCommand = "run";
+    inline static const std::string kShutdownCommand = "shutdown";
+    inline static const std::string kHousesField = "houses=";
+    inline static const std::string kAlgorithmsField = "algos=";
+    inline static const std::string kEndReply = "END";
+    inline static const std::string kErrorReply = "ERROR";
+    inline static constexpr const char kListSeparator = ',';
+    inline static constexpr const int kListenBacklog = 16;
+    inline static const std::string kShadowDirectoryPrefix = "myrobot-daemon-";
+
+    /**
+     * @brief Sends a reply line (including its line break) to the client.
+     */
+    using ReplyWriter = std::function<void(const std::string& reply_line)>;
+
+    /**
+     * @brief A parsed `run` request.
+     */
+    struct JobRequest
+    {
+        std::optional<std::set<std::string>> house_names;       // Houses to be simulated (all houses if not set).
+        std::optional<std::set<std::string>> algorithm_names;   // Algorithms to be simulated (all algorithms if not set).
+    };
+
+    /**
+     * @brief A read house, along with the modification time of its file at the time it was read.
+     */
+    struct CachedHouse
+    {
+        std::filesystem::file_time_type modification_time;
+        std::optional<HouseFile> house_file;                    // Not set if the house file is invalid.
+        std::string error_message;                              // The house file error (if it's invalid).
+    };
+
+    const Arguments& arguments;
+    const std::string socket_path;
+    int listen_socket;
+
+    std::map<std::filesystem::path, CachedHouse> houses;
+    std::map<std::filesystem::path, std::filesystem::file_time_type> algorithm_modification_times;
+    std::vector<void*> algorithm_handles;
+    std::size_t algorithm_generation;                           // Number of times the algorithms were (re)loaded.
+
+    bool is_running;
+
+    /**
+     * @brief Re-reads added or modified house files, and drops removed ones.
+     */
+    void refreshHouses();
+
+    /**
+     * @brief Reloads all algorithms if any algorithm file was added, removed or modified.
+     *
+     * A shared object which was dlopen()ed once may never be unloaded by dlclose() (e.g. due to unique symbols),
+     * in which case dlopen()ing the same path again returns the stale object. So each generation of the algorithms
+     * is dlopen()ed from a fresh copy, placed in a directory of its own.
+     */
+    void refreshAlgorithms();
+
+    /**
+     * @brief Parses a single request line.
+     *
+     * @throws std::invalid_argument On an unknown command or field.
+     */
+    JobRequest parseRequest(const std::string& request_line);
+
+    /**
+     * @brief Runs a single job, writing its reply (excluding the terminating `END` line) as the job progresses.
+     */
+    void runJob(const JobRequest& request, const ReplyWriter& writeReply);
+
+    /**
+     * @brief Handles a single request line, writing its full reply.
+     */
+    void handleRequest(const std::string& request_line, const ReplyWriter& writeReply);
+
+    /**
+     * @brief Serves all requests sent over a single client connection, until the client disconnects.
+     */
+    void serveConnection(int connection_socket);
+
+public:
+    /**
+     * @brief Creates a daemon listening on the socket path given in the arguments.
+     *
+     * @param arguments The run arguments (must outlive the daemon).
+     *
+     * @throws std::runtime_error If the socket couldn't be created, bound or listened on.
+     */
+    Daemon(const Arguments& arguments);
+
+    ~Daemon();
+
+    Daemon(const Daemon& daemon) = delete;
+    Daemon& operator=(const Daemon& daemon) = delete;
+
+    /**
+     * @brief Serves client connections (one at a time) until a `shutdown` request is received.
+     */
+    void serve();
+};
+
+#endif /* DAEMON_H_ */
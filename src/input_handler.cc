@@ -3,8 +3,14 @@
 #include "algorithm/AlgorithmRegistration.h"
 
 #include "output_handler.h"
+#include "trace_recorder.h"
 
+#include <algorithm>
 #include <exception>
+#include <fstream>
+#include <sstream>
+#include <regex>
+#include <set>
 
 void InputHandler::searchDirectory(const std::string& directory_path_string,
                                    const std::function<bool(const std::filesystem::directory_entry&)>& foundCriteria,
@@ -50,11 +56,95 @@ void InputHandler::findHouses(const std::string& house_directory_path, std::vect
                     storeHouse);
 }
 
+void InputHandler::findStepLogs(const std::string& log_directory_path, std::vector<std::filesystem::path>& log_paths)
+{
+    auto isStepLogFile = [](const std::filesystem::directory_entry& entry) -> bool
+    {
+        if (entry.is_regular_file() && kStepLogExtension == entry.path().extension())
+        {
+            return true;
+        }
+        return false;
+    };
+
+    auto storeStepLog = [&log_paths](const std::filesystem::path& log_path)
+    {
+        log_paths.emplace_back(log_path);
+    };
+
+    searchDirectory(log_directory_path,
+                    isStepLogFile,
+                    storeStepLog);
+}
+
+void InputHandler::readStepLog(const std::filesystem::path& log_path, std::vector<Step>& steps)
+{
+    static const std::map<char, Step> kStepCharacters = {
+        {'N', Step::North},
+        {'E', Step::East},
+        {'S', Step::South},
+        {'W', Step::West},
+        {'s', Step::Stay},
+        {'F', Step::Finish}
+    };
+
+    std::ifstream log_file(log_path);
+    if (!log_file.is_open())
+    {
+        throw std::runtime_error("Couldn't open step log \"" + log_path.string() + "\"");
+    }
+
+    std::string line;
+    while (std::getline(log_file, line) && kStepLogStepsLine != line);
+
+    if (kStepLogStepsLine != line)
+    {
+        throw std::runtime_error("Step log \"" + log_path.string() + "\" has no " + kStepLogStepsLine + " line");
+    }
+
+    std::string step_line;
+    std::getline(log_file, step_line);
+
+    steps.reserve(step_line.size());
+    for (char step_character : step_line)
+    {
+        auto step = kStepCharacters.find(step_character);
+        if (kStepCharacters.end() == step)
+        {
+            throw std::runtime_error("Invalid step '" + std::string(1, step_character) + "' in step log \"" + log_path.string() + "\"");
+        }
+
+        steps.push_back(step->second);
+    }
+}
+
+void InputHandler::findAlgorithms(const std::string& algorithm_directory_path, std::vector<std::filesystem::path>& algorithm_paths)
+{
+    auto isAlgorithmFile = [](const std::filesystem::directory_entry& entry) -> bool
+    {
+        if (entry.is_regular_file() && kAlgorithmExtension == entry.path().extension())
+        {
+            return true;
+        }
+        return false;
+    };
+
+    auto storeAlgorithm = [&algorithm_paths](const std::filesystem::path& algorithm_path)
+    {
+        algorithm_paths.emplace_back(algorithm_path);
+    };
+
+    searchDirectory(algorithm_directory_path,
+                    isAlgorithmFile,
+                    storeAlgorithm);
+}
+
 void InputHandler::readHouses(const std::vector<std::filesystem::path>& house_paths, std::vector<HouseFile>& house_files)
 {
     for (const auto& house_path : house_paths)
     {
         house_files.emplace_back();
+        TraceRecorder::ScopedSpan parse_span("input", "parse house", TraceRecorder::formatArgument("path", house_path.string()));
 
         try
         {
@@ -96,27 +186,19 @@ bool InputHandler::safeDlOpen(void*& handle, const std::filesystem::path& file_p
 
 void InputHandler::openAlgorithms(const std::string& algorithm_directory_path, std::vector<void*>& algorithm_handles)
 {
-    auto isAlgorithmFile = [](const std::filesystem::directory_entry& entry) -> bool
-    {
-        if (entry.is_regular_file() && kAlgorithmExtension == entry.path().extension())
-        {
-            return true;
-        }
-        return false;
-    };
+    std::vector<std::filesystem::path> algorithm_paths;
+    findAlgorithms(algorithm_directory_path, algorithm_paths);
 
-    auto loadAlgorithm = [&algorithm_handles](const std::filesystem::path& entry_path)
+    for (const auto& algorithm_path : algorithm_paths)
     {
         void* handle;
-        if (safeDlOpen(handle, entry_path))
+        TraceRecorder::ScopedSpan dlopen_span("input", "dlopen", TraceRecorder::formatArgument("path", algorithm_path.string()));
+
+        if (safeDlOpen(handle, algorithm_path))
         {
             algorithm_handles.emplace_back(handle);
         }
-    };
-
-    searchDirectory(algorithm_directory_path,
-                    isAlgorithmFile,
-                    loadAlgorithm);
+    }
 }
 
 void InputHandler::closeAlgorithms(std::vector<void*>& algorithm_handles)
@@ -127,6 +209,195 @@ void InputHandler::closeAlgorithms(std::vector<void*>& algorithm_handles)
     }
 }
 
+ShardSpec InputHandler::parseShard(const std::string& raw_shard)
+{
+    std::size_t separator_position = raw_shard.find(kShardSeparator);
+    if (std::string::npos == separator_position)
+    {
+        throw std::invalid_argument("Invalid shard (expected <index>/<count>): " + raw_shard);
+    }
+
+    ShardSpec shard = {
+        .index = std::stoul(raw_shard.substr(0, separator_position)),
+        .count = std::stoul(raw_shard.substr(separator_position + kShardSeparator.size()))
+    };
+
+    if (0 == shard.count || shard.index >= shard.count)
+    {
+        throw std::invalid_argument("Invalid shard (index must be less than a non-zero count): " + raw_shard);
+    }
+
+    return shard;
+}
+
+void InputHandler::readPartialTable(const std::filesystem::path& partial_path,
+                                    std::map<std::string, std::map<std::string, std::string>>& rows)
+{
+    std::ifstream partial_file(partial_path);
+    if (!partial_file.is_open())
+    {
+        throw std::runtime_error("Couldn't open partial results file \"" + partial_path.string() + "\"");
+    }
+
+    std::string line;
+
+    // Skip header line
+    std::getline(partial_file, line);
+
+    while (std::getline(partial_file, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        std::istringstream line_stream(line);
+        std::string algorithm_name;
+        std::string house_name;
+        std::string fields;
+
+        if (!std::getline(line_stream, algorithm_name, ',')
+            || !std::getline(line_stream, house_name, ',')
+            || !std::getline(line_stream, fields))
+        {
+            throw std::runtime_error("Malformed line in partial results file \"" + partial_path.string() + "\": " + line);
+        }
+
+        rows[algorithm_name].insert(std::make_pair(house_name, fields));
+    }
+}
+
+void InputHandler::readShardPartials(const std::string& partials_directory_path,
+                                     std::map<std::string, std::map<std::string, std::size_t>>& scores,
+                                     std::map<std::string, std::map<std::string, std::string>>& performance_rows,
+                                     std::map<std::string, std::map<std::string, std::string>>& step_latency_rows,
+                                     std::map<std::string, std::map<std::string, std::string>>& planner_stats_rows,
+                                     std::map<std::string, std::vector<std::string>>& module_errors)
+{
+    // Matches file names tagged by OutputHandler::getShardTag(), e.g. `summary.shard-0-of-4.csv`.
+    static const std::regex kShardFilePattern(R"(^(.+)\.shard-(\d+)-of-(\d+)\.(csv|error)$)");
+    static const std::string kSummaryModule = "summary";
+    static const std::string kPerformanceModule = "performance";
+    static const std::string kStepLatencyModule = "step_latency";
+    static const std::string kPlannerStatsModule = "planner_stats";
+
+    std::map<std::size_t, std::filesystem::path> partial_summaries;
+    std::vector<std::filesystem::path> partial_performance;
+    std::vector<std::filesystem::path> partial_step_latencies;
+    std::vector<std::filesystem::path> partial_planner_stats;
+    std::vector<std::pair<std::string, std::filesystem::path>> partial_errors;
+    std::optional<std::size_t> shard_count;
+
+    auto isShardFile = [](const std::filesystem::directory_entry& entry) -> bool
+    {
+        return entry.is_regular_file() && std::regex_match(entry.path().filename().string(), kShardFilePattern);
+    };
+
+    auto storeShardFile = [&](const std::filesystem::path& shard_file_path)
+    {
+        std::smatch match;
+        std::string file_name = shard_file_path.filename().string();
+        std::regex_match(file_name, match, kShardFilePattern);
+
+        std::size_t index = std::stoul(match[2].str());
+        std::size_t count = std::stoul(match[3].str());
+
+        if (shard_count.has_value() && shard_count.value() != count)
+        {
+            throw std::runtime_error("Found partial results of different shard counts (" + std::to_string(shard_count.value()) + " and " + std::to_string(count) + ")");
+        }
+        shard_count = count;
+
+        if ("csv" == match[4].str() && kSummaryModule == match[1].str())
+        {
+            partial_summaries[index] = shard_file_path;
+        }
+
+        else if ("csv" == match[4].str() && kPerformanceModule == match[1].str())
+        {
+            partial_performance.push_back(shard_file_path);
+        }
+
+        else if ("csv" == match[4].str() && kStepLatencyModule == match[1].str())
+        {
+            partial_step_latencies.push_back(shard_file_path);
+        }
+
+        else if ("csv" == match[4].str() && kPlannerStatsModule == match[1].str())
+        {
+            partial_planner_stats.push_back(shard_file_path);
+        }
+
+        else if ("error" == match[4].str())
+        {
+            partial_errors.emplace_back(match[1].str(), shard_file_path);
+        }
+    };
+
+    searchDirectory(partials_directory_path, isShardFile, storeShardFile);
+
+    if (!shard_count.has_value())
+    {
+        throw std::runtime_error("No shard partial results were found in " + partials_directory_path);
+    }
+
+    for (std::size_t index = 0; index < shard_count.value(); index++)
+    {
+        if (!partial_summaries.contains(index))
+        {
+            throw std::runtime_error("Missing partial summary of shard " + std::to_string(index) + " (out of " + std::to_string(shard_count.value()) + ")");
+        }
+    }
+
+    for (const auto& partial_summary : partial_summaries)
+    {
+        std::map<std::string, std::map<std::string, std::string>> score_rows;
+        readPartialTable(partial_summary.second, score_rows);
+
+        for (const auto& algorithm_row : score_rows)
+        {
+            for (const auto& house_column : algorithm_row.second)
+            {
+                scores[algorithm_row.first].insert(std::make_pair(house_column.first, std::stoul(house_column.second)));
+            }
+        }
+    }
+
+    for (const auto& performance_path : partial_performance)
+    {
+        readPartialTable(performance_path, performance_rows);
+    }
+
+    for (const auto& step_latency_path : partial_step_latencies)
+    {
+        readPartialTable(step_latency_path, step_latency_rows);
+    }
+
+    for (const auto& planner_stats_path : partial_planner_stats)
+    {
+        readPartialTable(planner_stats_path, planner_stats_rows);
+    }
+
+    // Sort error files so merged errors are in a deterministic (shard) order
+    std::sort(partial_errors.begin(), partial_errors.end());
+
+    std::map<std::string, std::set<std::string>> seen_errors;
+    for (const auto& [module_name, error_path] : partial_errors)
+    {
+        std::ifstream error_file(error_path);
+        std::string line;
+
+        while (std::getline(error_file, line))
+        {
+            // Errors which don't depend on the shard (e.g. invalid house files) are reported by all shards
+            if (!line.empty() && seen_errors[module_name].insert(line).second)
+            {
+                module_errors[module_name].push_back(line);
+            }
+        }
+    }
+}
+
 bool InputHandler::parseArgument(const std::string& raw_argument, Arguments& arguments)
 {
     if (raw_argument.starts_with("-house_path"))
@@ -149,9 +420,94 @@ bool InputHandler::parseArgument(const std::string& raw_argument, Arguments& arg
         arguments.summary_only = true;
     }
 
+    else if (raw_argument.starts_with("-shard"))
+    {
+        arguments.shard = parseShard(raw_argument.substr(raw_argument.find("=") + 1));
+    }
+
+    else if ("-merge" == raw_argument)
+    {
+        arguments.merge = true;
+    }
+
+    else if (raw_argument.starts_with("-cpu_timeout"))
+    {
+        arguments.cpu_timeout = true;
+
+        if (std::string::npos != raw_argument.find("="))
+        {
+            arguments.wall_ceiling_factor = std::stoul(raw_argument.substr(raw_argument.find("=") + 1));
+        }
+
+        if (0 == arguments.wall_ceiling_factor)
+        {
+            throw std::invalid_argument("Invalid wall-clock ceiling factor (must be positive): " + raw_argument);
+        }
+    }
+
+    else if ("-isolate" == raw_argument)
+    {
+        arguments.isolate = true;
+    }
+
+    else if (raw_argument.starts_with("-daemon="))
+    {
+        arguments.daemon_socket = raw_argument.substr(raw_argument.find("=") + 1);
+    }
+
+    else if (raw_argument.starts_with("-step_slice="))
+    {
+        arguments.step_slice = std::stoul(raw_argument.substr(raw_argument.find("=") + 1));
+        if (0 == arguments.step_slice)
+        {
+            throw std::invalid_argument("Invalid step slice (must be positive): " + raw_argument);
+        }
+    }
+
+    else if (raw_argument.starts_with("-replay"))
+    {
+        std::size_t value_position = raw_argument.find("=");
+        arguments.replay_path = (std::string::npos == value_position) ? kDefaultReplayPath : raw_argument.substr(value_position + 1);
+    }
+
+    else if (raw_argument.starts_with("-detect_cycles"))
+    {
+        std::size_t value_position = raw_argument.find("=");
+        arguments.cycle_check_interval = (std::string::npos == value_position) ? kDefaultCycleCheckInterval : std::stoul(raw_argument.substr(value_position + 1));
+        if (0 == arguments.cycle_check_interval)
+        {
+            throw std::invalid_argument("Invalid cycle check interval (must be positive): " + raw_argument);
+        }
+    }
+
+    else if (raw_argument.starts_with("-batch"))
+    {
+        std::size_t value_position = raw_argument.find("=");
+        arguments.batch_size = (std::string::npos == value_position) ? kDefaultBatchSize : std::stoul(raw_argument.substr(value_position + 1));
+        if (0 == arguments.batch_size)
+        {
+            throw std::invalid_argument("Invalid batch size (must be positive): " + raw_argument);
+        }
+    }
+
+    else if ("-step_latency" == raw_argument)
+    {
+        arguments.step_latency = true;
+    }
+
+    else if (raw_argument.starts_with("-trace="))
+    {
+        arguments.trace_path = raw_argument.substr(raw_argument.find("=") + 1);
+    }
+
+    else if (raw_argument.starts_with("-metrics="))
+    {
+        arguments.metrics_path = raw_argument.substr(raw_argument.find("=") + 1);
+    }
+
     else if (raw_argument.starts_with("-h") || raw_argument.starts_with("-help") || raw_argument.starts_with("--help"))
     {
-        OutputHandler::printMessage("Usage: myrobot [-house_path=<path>] [-algo_path=<path>] [-num_threads=<num>] [-summary_only]");
+        OutputHandler::printMessage("Usage: myrobot [-house_path=<path>] [-algo_path=<path>] [-num_threads=<num>] [-summary_only] [-shard=<index>/<count>] [-merge] [-cpu_timeout[=<wall_ceiling_factor>]] [-isolate] [-daemon=<socket_path>] [-step_slice=<steps>] [-replay[=<log_path>]] [-detect_cycles[=<interval>]] [-batch[=<houses>]] [-step_latency] [-trace=<trace_file>] [-metrics=<metrics_file>]");
         return false;
     }
 
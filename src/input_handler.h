@@ -6,25 +6,55 @@
 
 #include <filesystem>
 #include <functional>
+#include <optional>
 #include <cstddef>
 #include <dlfcn.h>
 #include <vector>
 #include <string>
+#include <map>
 
 using namespace std::string_literals;
 
+/**
+ * @brief Identifies a single shard of a run split across several processes (or machines).
+ */
+struct ShardSpec
+{
+    std::size_t index;      // Zero-based index of the shard.
+    std::size_t count;      // Total number of shards the run is split into.
+};
+
 struct Arguments
 {
     std::string house_path;
     std::string algorithm_path;
     std::size_t num_threads;
     bool summary_only;
+    std::optional<ShardSpec> shard;     // When set - simulate only this shard's subset of the algorithm - house pairs.
+    bool merge;                         // Whether to merge previously written shard partial results (instead of simulating).
+    bool cpu_timeout;                   // Whether to enforce the tasks' time budget in CPU time (instead of wall-clock time).
+    std::size_t wall_ceiling_factor;    // Wall-clock ceiling of CPU time budgets (as a multiple of the budget).
+    bool isolate;                       // Whether to simulate pairs in isolated worker processes (instead of threads).
+    std::optional<std::string> daemon_socket;   // When set - serve jobs on this Unix domain socket (instead of a single run).
+    std::size_t step_slice;             // When non-zero - interleave simulations in slices of this number of steps.
+    std::optional<std::string> replay_path;     // When set - re-score the step logs in this directory (instead of simulating).
+    std::size_t cycle_check_interval;   // When non-zero - finish livelocked simulations early, sampling their state every this number of steps.
+    std::size_t batch_size;             // When non-zero - simulate each algorithm's houses in lockstep batches of this number of houses.
+    bool step_latency;                  // Whether to time the algorithms' step calls (exporting their latency percentiles).
+    std::optional<std::string> trace_path;      // When set - record a timeline of the run into this Chrome trace-event JSON file.
+    std::optional<std::string> metrics_path;    // When set - periodically rewrite the run's progress into this Prometheus text format file.
 };
 
 class InputHandler
 {
     inline static const std::string kAlgorithmExtension = ".so"s;
     inline static const std::string kHouseExtension = ".house"s;
+    inline static const std::string kShardSeparator = "/"s;
+    inline static const std::string kStepLogExtension = ".txt"s;
+    inline static const std::string kStepLogStepsLine = "Steps:"s;
+    inline static const std::string kDefaultReplayPath = "."s;
+    inline static const std::size_t kDefaultCycleCheckInterval = 64;
+    inline static const std::size_t kDefaultBatchSize = 64;
 
     /**
      * @brief Parses a single command line argument.
@@ -60,6 +90,28 @@ class InputHandler
      */
     static bool safeDlOpen(void*& handle, const std::filesystem::path& file_path);
 
+    /**
+     * @brief Parses a shard specification of the form `<index>/<count>`.
+     * 
+     * @param raw_shard The shard specification to be parsed.
+     * 
+     * @throws std::invalid_argument On malformed specification, zero count or an out of range index.
+     * 
+     * @return The parsed shard specification.
+     */
+    static ShardSpec parseShard(const std::string& raw_shard);
+
+    /**
+     * @brief Reads a single shard partial results file (long `algorithm,house,<fields>` format).
+     * 
+     * @param partial_path The path of the partial results file.
+     * @param rows The data structure to store the read (unparsed) fields of each algorithm - house pair into.
+     * 
+     * @throws std::runtime_error If the file couldn't be opened or contains a malformed line.
+     */
+    static void readPartialTable(const std::filesystem::path& partial_path,
+                                 std::map<std::string, std::map<std::string, std::string>>& rows);
+
 public:
     /**
     * @brief Deleted deault empty constructor.
@@ -84,6 +136,32 @@ public:
      */
     static void readHouses(const std::vector<std::filesystem::path>& house_paths, std::vector<HouseFile>& house_files);
 
+    /**
+     * @brief Find all step log (`<house>-<algorithm>.txt` output) files in a given directory.
+     * 
+     * @param log_directory_path The directory path to search the step logs at.
+     * @param log_paths The vector to store found step log paths into.
+     */
+    static void findStepLogs(const std::string& log_directory_path, std::vector<std::filesystem::path>& log_paths);
+
+    /**
+     * @brief Reads the steps of a step log (the line following its `Steps:` line).
+     * 
+     * @param log_path The path of the step log.
+     * @param steps The vector to store the read steps into.
+     * 
+     * @throws std::runtime_error If the file couldn't be opened, has no `Steps:` line or contains an invalid step.
+     */
+    static void readStepLog(const std::filesystem::path& log_path, std::vector<Step>& steps);
+
+    /**
+     * @brief Find all `.so` files in a given directory.
+     * 
+     * @param algorithm_directory_path The directory path to search the `.so` files at.
+     * @param algorithm_paths The vector to store found algorithm file paths into.
+     */
+    static void findAlgorithms(const std::string& algorithm_directory_path, std::vector<std::filesystem::path>& algorithm_paths);
+
     /**
      * @brief Find all `.so` files in a given directory and try dlopen()ing them as algorithms.
      * 
@@ -99,6 +177,27 @@ public:
      */
     static void closeAlgorithms(std::vector<void*>& algorithm_handles);
 
+    /**
+     * @brief Reads all shard partial results (summaries and errors) written into a given directory.
+     * 
+     * Makes sure all shards of the split run are present before reading anything.
+     * 
+     * @param partials_directory_path The directory path to search the shard partial results at.
+     * @param scores The scores data structure to store the merged scores into.
+     * @param performance_rows The merged (formatted) performance reports of each algorithm - house pair.
+     * @param step_latency_rows The merged (formatted) step latency reports of each timed algorithm - house pair.
+     * @param planner_stats_rows The merged (formatted) planner stats reports of each algorithm - house pair (which reported them).
+     * @param module_errors The merged error messages of each module (algorithm / house), without duplicates.
+     * 
+     * @throws std::runtime_error If no partial results were found, or some of the shards are missing.
+     */
+    static void readShardPartials(const std::string& partials_directory_path,
+                                  std::map<std::string, std::map<std::string, std::size_t>>& scores,
+                                  std::map<std::string, std::map<std::string, std::string>>& performance_rows,
+                                  std::map<std::string, std::map<std::string, std::string>>& step_latency_rows,
+                                  std::map<std::string, std::map<std::string, std::string>>& planner_stats_rows,
+                                  std::map<std::string, std::vector<std::string>>& module_errors);
+
     /**
      * @brief Parses command line arguments.
      * 
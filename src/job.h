@@ -0,0 +1,43 @@
+#ifndef JOB_H_
+#define JOB_H_
+
+#include "task_performance.h"
+
+#include "simulator/deserializer.h"
+
+#include "common/AlgorithmRegistrar.h"
+
+#include <string>
+#include <cstddef>
+
+/**
+ * @brief A single algorithm - house pair to be simulated (by a WorkerPool or a SliceScheduler).
+ */
+struct Job
+{
+    std::string algorithm_name;
+    AlgorithmFactory algorithm_factory;
+    const HouseFile* house_file;
+    std::size_t cycle_check_interval = 0;   // The simulation's cycle detection interval (see Simulator::enableCycleDetection()).
+    bool is_step_timed = false;             // Whether the algorithm's step calls are timed (see Simulator::enableStepTiming()).
+};
+
+/**
+ * @brief The result of a single job.
+ */
+struct JobResult
+{
+    std::size_t score;
+    std::string algorithm_error;
+    TaskPerformance performance;
+};
+
+/**
+ * @brief Formats an error raised while simulating a job, tagged with the job's house (the same way as a Task does).
+ */
+inline std::string formatJobError(const Job& job, const std::string& error_message)
+{
+    return "[house=" + job.house_file->name + "]" + error_message;
+}
+
+#endif /* JOB_H_ */
@@ -3,6 +3,8 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <utility>
+#include <algorithm>
 #include <thread>
 #include <cstdlib>
 #include <iostream>
@@ -16,6 +18,13 @@
 #include "input_handler.h"
 #include "task_queue.h"
 #include "task.h"
+#include "worker_pool.h"
+#include "daemon.h"
+#include "slice_scheduler.h"
+#include "replayer.h"
+#include "batch_runner.h"
+#include "trace_recorder.h"
+#include "metrics_exporter.h"
 
 namespace Constants
 {
@@ -27,11 +36,46 @@ namespace Constants
     const std::string kDefaultHousePath = ".";
     const std::size_t kDefaultNumThreads = 10;
     const bool kDefaultSummaryOnly = false;
+    const bool kDefaultMerge = false;
+    const bool kDefaultCpuTimeout = false;
+    const std::size_t kDefaultWallCeilingFactor = 10;
+    const bool kDefaultIsolate = false;
+    const std::size_t kDefaultStepSlice = 0;
+    const std::size_t kDefaultCycleCheckInterval = 0;
+    const std::size_t kDefaultBatchSize = 0;
+    const bool kDefaultStepLatency = false;
+
+    const std::string kOutputPath = ".";
 }
 
-void handleResults(TaskQueue& task_queue, bool summary_only)
+using AlgorithmEntry = decltype(std::declval<const AlgorithmRegistrar&>().begin());
+using AlgorithmHousePair = std::pair<AlgorithmEntry, const HouseFile*>;
+
+void exportRunResults(const std::map<std::string, std::map<std::string, std::size_t>>& task_scores,
+                      const std::map<std::string, std::map<std::string, TaskPerformance>>& task_performance,
+                      bool is_sharded)
+{
+    TraceRecorder::ScopedSpan export_span("run", "export results");
+
+    if (is_sharded)
+    {
+        OutputHandler::exportPartialSummary(task_scores);
+    }
+
+    else
+    {
+        OutputHandler::exportSummary(task_scores);
+    }
+
+    OutputHandler::exportPerformance(task_performance);
+    OutputHandler::exportStepLatencies(task_performance);
+    OutputHandler::exportPlannerStats(task_performance);
+}
+
+void handleResults(TaskQueue& task_queue, bool summary_only, bool is_sharded)
 {
     std::map<std::string, std::map<std::string, std::size_t>> task_scores;
+    std::map<std::string, std::map<std::string, TaskPerformance>> task_performance;
 
     for (auto& task : task_queue)
     {
@@ -47,48 +91,333 @@ void handleResults(TaskQueue& task_queue, bool summary_only)
         // Occupy tasks scores
         task_scores[task.getAlgorithmName()].insert(std::make_pair(task.getHouseName(), task.getScore()));
 
+        // Occupy tasks resources usage
+        task_performance[task.getAlgorithmName()].insert(std::make_pair(task.getHouseName(), task.getPerformance()));
+
         // Detaching tasks after reading their score as an extra measure for stuck thread (although they should be already cancelled).
         task.detach();
     }
 
-    OutputHandler::exportSummary(task_scores);
+    exportRunResults(task_scores, task_performance, is_sharded);
 }
 
-void runTaskQueue(std::vector<HouseFile>& house_files, std::size_t num_tasks, std::size_t num_threads, bool summary_only)
+/**
+ * @brief Selects the algorithm - house pairs to be simulated.
+ * 
+ * When sharded, pairs are ordered by (algorithm name, house name) - which doesn't depend on directory scanning order,
+ * and are dealt to the shards round-robin, so each shard deterministically gets a balanced share of the pairs.
+ */
+std::vector<AlgorithmHousePair> selectPairs(const std::vector<HouseFile>& house_files, const std::optional<ShardSpec>& shard)
 {
-    TaskQueue task_queue(num_tasks, num_threads);
+    std::vector<AlgorithmHousePair> pairs;
 
-    for(const auto& algorithm : AlgorithmRegistrar::getAlgorithmRegistrar())
+    const AlgorithmRegistrar& registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+    for (auto algorithm = registrar.begin(); algorithm != registrar.end(); algorithm++)
     {
         for (const auto& house_file : house_files)
         {
-            task_queue.insertTask(
-                algorithm.name(),
-                algorithm.create(),
-                house_file
-            );
+            pairs.emplace_back(algorithm, &house_file);
         }
     }
 
+    if (!shard.has_value())
+    {
+        return pairs;
+    }
+
+    std::sort(pairs.begin(), pairs.end(), [](const AlgorithmHousePair& first, const AlgorithmHousePair& second)
+    {
+        return std::tie(first.first->name(), first.second->name) < std::tie(second.first->name(), second.second->name);
+    });
+
+    std::vector<AlgorithmHousePair> shard_pairs;
+    for (std::size_t i = shard->index; i < pairs.size(); i += shard->count)
+    {
+        shard_pairs.push_back(pairs[i]);
+    }
+
+    return shard_pairs;
+}
+
+void runTaskQueue(const std::vector<AlgorithmHousePair>& pairs, const Arguments& arguments)
+{
+    TimeoutPolicy timeout_policy = {
+        .is_cpu_time = arguments.cpu_timeout,
+        .wall_ceiling_factor = arguments.wall_ceiling_factor
+    };
+
+    TaskQueue task_queue(pairs.size(), arguments.num_threads, timeout_policy);
+
+    std::optional<MetricsExporter> metrics_exporter;
+    if (arguments.metrics_path.has_value())
+    {
+        task_queue.enableRunMetrics();
+        metrics_exporter.emplace(*task_queue.getRunMetrics(), arguments.metrics_path.value());
+    }
+
+    for (const auto& [algorithm, house_file] : pairs)
+    {
+        task_queue.insertTask(
+            algorithm->name(),
+            algorithm->create(),
+            *house_file,
+            arguments.cycle_check_interval,
+            arguments.step_latency
+        );
+    }
+
     task_queue.run();
 
-    handleResults(task_queue, summary_only);
+    // The final metrics (all tasks done)
+    metrics_exporter.reset();
+
+    handleResults(task_queue, arguments.summary_only, arguments.shard.has_value());
+}
+
+std::vector<Job> createJobs(const std::vector<AlgorithmHousePair>& pairs, std::size_t cycle_check_interval, bool is_step_timed)
+{
+    std::vector<Job> jobs;
+    for (const auto& [algorithm, house_file] : pairs)
+    {
+        jobs.push_back({
+            .algorithm_name = algorithm->name(),
+            .algorithm_factory = [algorithm]() { return algorithm->create(); },
+            .house_file = house_file,
+            .cycle_check_interval = cycle_check_interval,
+            .is_step_timed = is_step_timed
+        });
+    }
+
+    return jobs;
+}
+
+/**
+ * @brief Exports the results of finished jobs (the jobs' statistics files are exported by their runner).
+ *
+ * @param runner A finished WorkerPool or SliceScheduler.
+ */
+template <typename JobRunner>
+void handleJobResults(const std::vector<Job>& jobs, const JobRunner& runner, bool is_sharded)
+{
+    std::map<std::string, std::map<std::string, std::size_t>> task_scores;
+    std::map<std::string, std::map<std::string, TaskPerformance>> task_performance;
+
+    for (std::size_t i = 0; i < jobs.size(); i++)
+    {
+        const JobResult& result = runner.getResult(i);
+        const std::string& house_name = jobs[i].house_file->name;
+
+        OutputHandler::exportError(jobs[i].algorithm_name, result.algorithm_error);
+
+        task_scores[jobs[i].algorithm_name].insert(std::make_pair(house_name, result.score));
+        task_performance[jobs[i].algorithm_name].insert(std::make_pair(house_name, result.performance));
+    }
+
+    exportRunResults(task_scores, task_performance, is_sharded);
+}
+
+/**
+ * @brief Simulates the given pairs in isolated worker processes (so a crashing algorithm can't take the run down).
+ */
+void runWorkerPool(const std::vector<AlgorithmHousePair>& pairs, const Arguments& arguments)
+{
+    TimeoutPolicy timeout_policy = {
+        .is_cpu_time = arguments.cpu_timeout,
+        .wall_ceiling_factor = arguments.wall_ceiling_factor
+    };
+
+    std::vector<Job> jobs = createJobs(pairs, arguments.cycle_check_interval, arguments.step_latency);
+
+    WorkerPool worker_pool(jobs, arguments.num_threads, timeout_policy, arguments.summary_only);
+    worker_pool.run();
+
+    handleJobResults(jobs, worker_pool, arguments.shard.has_value());
+}
+
+/**
+ * @brief Simulates the given pairs in step slices, interleaved over `num_threads` threads.
+ */
+void runSliceScheduler(const std::vector<AlgorithmHousePair>& pairs, const Arguments& arguments)
+{
+    TimeoutPolicy timeout_policy = {
+        .is_cpu_time = arguments.cpu_timeout,
+        .wall_ceiling_factor = arguments.wall_ceiling_factor
+    };
+
+    std::vector<Job> jobs = createJobs(pairs, arguments.cycle_check_interval, arguments.step_latency);
+
+    SliceScheduler slice_scheduler(jobs, arguments.num_threads, arguments.step_slice, timeout_policy, arguments.summary_only);
+    slice_scheduler.run();
+
+    handleJobResults(jobs, slice_scheduler, arguments.shard.has_value());
+}
+
+/**
+ * @brief Simulates the given pairs in lockstep batches of houses (per algorithm), over `num_threads` threads.
+ */
+void runBatchRunner(const std::vector<AlgorithmHousePair>& pairs, const Arguments& arguments)
+{
+    std::vector<Job> jobs = createJobs(pairs, arguments.cycle_check_interval, arguments.step_latency);
+
+    BatchRunner batch_runner(jobs, arguments.num_threads, arguments.batch_size, arguments.summary_only);
+    batch_runner.run();
+
+    handleJobResults(jobs, batch_runner, arguments.shard.has_value());
+}
+
+void mergeShards()
+{
+    std::map<std::string, std::map<std::string, std::size_t>> task_scores;
+    std::map<std::string, std::map<std::string, std::string>> performance_rows;
+    std::map<std::string, std::map<std::string, std::string>> step_latency_rows;
+    std::map<std::string, std::map<std::string, std::string>> planner_stats_rows;
+    std::map<std::string, std::vector<std::string>> module_errors;
+
+    InputHandler::readShardPartials(Constants::kOutputPath, task_scores, performance_rows, step_latency_rows, planner_stats_rows, module_errors);
+
+    for (const auto& [module_name, error_lines] : module_errors)
+    {
+        std::ostringstream error_message;
+        for (std::size_t i = 0; i < error_lines.size(); i++)
+        {
+            error_message << (0 == i ? "" : "\n") << error_lines[i];
+        }
+
+        OutputHandler::exportErrorFile(module_name, error_message.str());
+    }
+
+    OutputHandler::exportSummary(task_scores);
+    OutputHandler::exportPerformance(performance_rows);
+
+    if (!step_latency_rows.empty())
+    {
+        OutputHandler::exportStepLatencies(step_latency_rows);
+    }
+
+    if (!planner_stats_rows.empty())
+    {
+        OutputHandler::exportPlannerStats(planner_stats_rows);
+    }
+}
+
+/**
+ * @brief Re-scores the step logs in the replay path (rewriting them into the output path, unless summary_only).
+ */
+void replayStepLogs(const Arguments& arguments)
+{
+    std::vector<std::filesystem::path> house_paths;
+    std::vector<HouseFile> house_files;
+    std::vector<std::filesystem::path> log_paths;
+
+    InputHandler::findHouses(arguments.house_path, house_paths);
+    InputHandler::readHouses(house_paths, house_files);
+    InputHandler::findStepLogs(arguments.replay_path.value(), log_paths);
+
+    Replayer replayer(house_files, log_paths, arguments.num_threads);
+    replayer.run();
+
+    std::map<std::string, std::map<std::string, std::size_t>> task_scores;
+    std::map<std::string, std::string> algorithm_errors;
+
+    const std::vector<Replayer::StepLog>& step_logs = replayer.getStepLogs();
+    for (std::size_t i = 0; i < step_logs.size(); i++)
+    {
+        const Replayer::ReplayResult& result = replayer.getResult(i);
+        const std::string& algorithm_name = step_logs[i].algorithm_name;
+        const std::string& house_name = step_logs[i].house_file->name;
+
+        if (!arguments.summary_only)
+        {
+            OutputHandler::exportStatistics(algorithm_name, house_name, result.statistics, result.score);
+        }
+
+        algorithm_errors[algorithm_name] += result.algorithm_error;
+        task_scores[algorithm_name].insert(std::make_pair(house_name, result.score));
+    }
+
+    for (const auto& [algorithm_name, error_message] : algorithm_errors)
+    {
+        OutputHandler::exportError(algorithm_name, error_message);
+    }
+
+    OutputHandler::exportSummary(task_scores);
 }
 
 void Main::runAll(const Arguments& arguments)
 {
+    if (arguments.merge)
+    {
+        mergeShards();
+        return;
+    }
+
+    if (arguments.replay_path.has_value())
+    {
+        replayStepLogs(arguments);
+        return;
+    }
+
+    if (arguments.daemon_socket.has_value())
+    {
+        Daemon daemon(arguments);
+        daemon.serve();
+        return;
+    }
+
+    if (arguments.shard.has_value())
+    {
+        OutputHandler::setOutputTag(OutputHandler::getShardTag(arguments.shard->index, arguments.shard->count));
+    }
+
     std::vector<void*> algorithm_handles;
     std::vector<std::filesystem::path> house_paths;
     std::vector<HouseFile> house_files;
 
-    InputHandler::openAlgorithms(arguments.algorithm_path, algorithm_handles);
+    {
+        TraceRecorder::ScopedSpan load_span("run", "load algorithms and houses");
 
-    InputHandler::findHouses(arguments.house_path, house_paths);
-    InputHandler::readHouses(house_paths, house_files);
+        InputHandler::openAlgorithms(arguments.algorithm_path, algorithm_handles);
 
-    std::size_t num_tasks = algorithm_handles.size() * house_files.size();
+        InputHandler::findHouses(arguments.house_path, house_paths);
+        InputHandler::readHouses(house_paths, house_files);
+    }
 
-    runTaskQueue(house_files, num_tasks, arguments.num_threads, arguments.summary_only);
+    std::vector<AlgorithmHousePair> pairs = selectPairs(house_files, arguments.shard);
+
+    if (arguments.isolate && 0 != arguments.step_slice)
+    {
+        throw std::invalid_argument("-isolate and -step_slice can't be used together");
+    }
+
+    if (0 != arguments.batch_size && (arguments.isolate || 0 != arguments.step_slice || arguments.cpu_timeout || 0 != arguments.cycle_check_interval || arguments.step_latency))
+    {
+        throw std::invalid_argument("-batch can't be used together with -isolate, -step_slice, -cpu_timeout, -detect_cycles or -step_latency");
+    }
+
+    if (arguments.metrics_path.has_value() && (arguments.isolate || 0 != arguments.batch_size || 0 != arguments.step_slice))
+    {
+        throw std::invalid_argument("-metrics can't be used together with -isolate, -batch or -step_slice");
+    }
+
+    if (arguments.isolate)
+    {
+        runWorkerPool(pairs, arguments);
+    }
+
+    else if (0 != arguments.batch_size)
+    {
+        runBatchRunner(pairs, arguments);
+    }
+
+    else if (0 != arguments.step_slice)
+    {
+        runSliceScheduler(pairs, arguments);
+    }
+
+    else
+    {
+        runTaskQueue(pairs, arguments);
+    }
 
     AlgorithmRegistrar::getAlgorithmRegistrar().clear();
     InputHandler::closeAlgorithms(algorithm_handles);
@@ -100,7 +429,20 @@ int main(int argc, char* argv[])
         .house_path = Constants::kDefaultHousePath,
         .algorithm_path = Constants::kDefaultAlgorithmPath,
         .num_threads = Constants::kDefaultNumThreads,
-        .summary_only = Constants::kDefaultSummaryOnly
+        .summary_only = Constants::kDefaultSummaryOnly,
+        .shard = std::nullopt,
+        .merge = Constants::kDefaultMerge,
+        .cpu_timeout = Constants::kDefaultCpuTimeout,
+        .wall_ceiling_factor = Constants::kDefaultWallCeilingFactor,
+        .isolate = Constants::kDefaultIsolate,
+        .daemon_socket = std::nullopt,
+        .step_slice = Constants::kDefaultStepSlice,
+        .replay_path = std::nullopt,
+        .cycle_check_interval = Constants::kDefaultCycleCheckInterval,
+        .batch_size = Constants::kDefaultBatchSize,
+        .step_latency = Constants::kDefaultStepLatency,
+        .trace_path = std::nullopt,
+        .metrics_path = std::nullopt
     };
 
     try
@@ -108,7 +450,18 @@ int main(int argc, char* argv[])
         bool is_success = InputHandler::parseCmdArguments(argc, argv, arguments);
         if (is_success)
         {
+            if (arguments.trace_path.has_value())
+            {
+                TraceRecorder::enable();
+                TraceRecorder::setThreadName("main");
+            }
+
             Main::runAll(arguments);
+
+            if (arguments.trace_path.has_value())
+            {
+                TraceRecorder::exportTrace(arguments.trace_path.value());
+            }
         }
     }
 
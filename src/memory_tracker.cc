@@ -0,0 +1,64 @@
+#include "memory_tracker.h"
+
+#include <new>
+#include <cstdlib>
+#include <malloc.h>
+
+namespace
+{
+    constinit thread_local MemoryTracker::ThreadUsage thread_usage;
+}
+
+MemoryTracker::ThreadUsage& MemoryTracker::getThreadUsage()
+{
+    return thread_usage;
+}
+
+void MemoryTracker::recordAllocation(std::int64_t size_delta)
+{
+    // Only the owning thread writes its counters, so a relaxed load-modify-store is enough.
+    std::int64_t current_bytes = thread_usage.current_bytes.load(std::memory_order_relaxed) + size_delta;
+    thread_usage.current_bytes.store(current_bytes, std::memory_order_relaxed);
+
+    if (size_delta > 0)
+    {
+        thread_usage.num_allocations.store(thread_usage.num_allocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    if (current_bytes > thread_usage.peak_bytes.load(std::memory_order_relaxed))
+    {
+        thread_usage.peak_bytes.store(current_bytes, std::memory_order_relaxed);
+    }
+}
+
+/*
+ * Replacements of the global allocation functions.
+ * The array and nothrow variants are implemented (by the standard library) in terms of these.
+ */
+void* operator new(std::size_t size)
+{
+    void* pointer = std::malloc(0 == size ? 1 : size);
+    if (nullptr == pointer)
+    {
+        throw std::bad_alloc();
+    }
+
+    MemoryTracker::recordAllocation(static_cast<std::int64_t>(malloc_usable_size(pointer)));
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (nullptr == pointer)
+    {
+        return;
+    }
+
+    MemoryTracker::recordAllocation(-static_cast<std::int64_t>(malloc_usable_size(pointer)));
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    ::operator delete(pointer);
+}
@@ -0,0 +1,59 @@
+#ifndef MEMORY_TRACKER_H_
+#define MEMORY_TRACKER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The MemoryTracker class keeps per-thread heap allocation accounting.
+ *
+ * The global `operator new` / `operator delete` are replaced (see `memory_tracker.cc`) to count the bytes
+ * allocated (net of frees) by each thread, including allocations made by dlopen()ed algorithms.
+ * Counters are atomic (relaxed) only so they can be sampled from another thread (e.g. on a task timeout).
+ */
+class MemoryTracker
+{
+public:
+    /**
+     * @brief Heap usage of a single thread.
+     */
+    struct ThreadUsage
+    {
+        std::atomic<std::int64_t> current_bytes = 0;    // Bytes currently allocated by the thread (net of frees).
+        std::atomic<std::int64_t> peak_bytes = 0;       // High-water mark of `current_bytes` since the last reset.
+        std::atomic<std::int64_t> num_allocations = 0;  // Number of allocations since the last reset.
+    };
+
+    /**
+    * @brief Deleted deault empty constructor.
+    *
+    * The default empty constructor is deleted since it's useless, as all the MemoryTracker member functions are `static`.
+    */
+    MemoryTracker() = delete;
+
+    /**
+     * @brief Returns the heap usage counters of the calling thread.
+     */
+    static ThreadUsage& getThreadUsage();
+
+    /**
+     * @brief Resets the heap usage counters of the calling thread (so the peak is measured from now on).
+     */
+    static void resetThreadUsage()
+    {
+        ThreadUsage& usage = getThreadUsage();
+        usage.current_bytes.store(0, std::memory_order_relaxed);
+        usage.peak_bytes.store(0, std::memory_order_relaxed);
+        usage.num_allocations.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Accounts an allocation / free of a given size for the calling thread.
+     *
+     * @param size_delta The allocated (positive) or freed (negative) number of bytes.
+     */
+    static void recordAllocation(std::int64_t size_delta);
+};
+
+#endif /* MEMORY_TRACKER_H_ */
@@ -0,0 +1,172 @@
+#include "metrics_exporter.h"
+#include "output_handler.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <fstream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * @brief Writes a single (unlabeled) metric, along with its HELP and TYPE lines.
+     */
+    template <typename T>
+    void writeMetric(std::ostream& output, const char* name, const char* type, const char* help, T value)
+    {
+        output << "# HELP " << name << " " << help << "\n"
+               << "# TYPE " << name << " " << type << "\n"
+               << name << " ";
+
+        // Prometheus spells it NaN (streams write nan)
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            if (std::isnan(value))
+            {
+                output << "NaN\n";
+                return;
+            }
+        }
+
+        output << value << "\n";
+    }
+}
+
+MetricsExporter::MetricsExporter(const RunMetrics& run_metrics,
+                                 const std::filesystem::path& metrics_path,
+                                 std::chrono::steady_clock::duration export_interval)
+    : run_metrics(run_metrics),
+      metrics_path(metrics_path),
+      export_interval(export_interval),
+      last_export_time(run_metrics.start_time)
+{
+    exportMetrics();
+    exporter_thread = std::jthread([this](std::stop_token stop_token) { exportPeriodically(stop_token); });
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    exporter_thread.request_stop();
+    exporter_thread.join();
+
+    try
+    {
+        exportMetrics();
+    }
+
+    catch (const std::exception& exception)
+    {
+        OutputHandler::printError("MetricsExporter", exception.what());
+    }
+}
+
+std::size_t MetricsExporter::readResidentMemory()
+{
+    // The second field of statm is the number of resident pages
+    std::ifstream statm_file("/proc/self/statm");
+    std::size_t total_pages = 0;
+    std::size_t resident_pages = 0;
+
+    if (!(statm_file >> total_pages >> resident_pages))
+    {
+        return 0;
+    }
+
+    return resident_pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+void MetricsExporter::exportMetrics()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    std::size_t num_tasks = run_metrics.num_tasks.load(std::memory_order_relaxed);
+    std::size_t num_started = run_metrics.num_started.load(std::memory_order_relaxed);
+    std::size_t num_finished = run_metrics.num_finished.load(std::memory_order_relaxed);
+    std::size_t num_steps = run_metrics.num_steps.load(std::memory_order_relaxed);
+
+    // The counters are sampled one by one - keep them consistent with each other
+    num_started = std::clamp(num_started, num_finished, std::max(num_tasks, num_finished));
+
+    double elapsed_seconds = std::chrono::duration<double>(now - run_metrics.start_time).count();
+    double interval_seconds = std::chrono::duration<double>(now - last_export_time).count();
+
+    double steps_per_second = (interval_seconds > 0) ? static_cast<double>(num_steps - std::min(num_steps, last_num_steps)) / interval_seconds : 0.0;
+
+    // Extrapolated by the finished tasks so far (unknown until the first one finishes)
+    double eta_seconds = std::numeric_limits<double>::quiet_NaN();
+    if (num_finished >= num_tasks)
+    {
+        eta_seconds = 0;
+    }
+
+    else if (0 != num_finished)
+    {
+        eta_seconds = elapsed_seconds * static_cast<double>(num_tasks - num_finished) / static_cast<double>(num_finished);
+    }
+
+    last_export_time = now;
+    last_num_steps = num_steps;
+
+    std::filesystem::path temporary_path = metrics_path;
+    temporary_path += kTemporaryExtension;
+
+    {
+        std::ofstream metrics_file(temporary_path, std::ios::trunc);
+        if (!metrics_file.is_open())
+        {
+            throw std::runtime_error("Couldn't open metrics file \"" + temporary_path.string() + "\"");
+        }
+
+        metrics_file << "# HELP myrobot_tasks Algorithm - house pairs by their state.\n"
+                     << "# TYPE myrobot_tasks gauge\n"
+                     << "myrobot_tasks{state=\"queued\"} " << num_tasks - std::min(num_tasks, num_started) << "\n"
+                     << "myrobot_tasks{state=\"running\"} " << num_started - num_finished << "\n"
+                     << "myrobot_tasks{state=\"done\"} " << num_finished << "\n";
+
+        writeMetric(metrics_file, "myrobot_timeouts_total", "counter", "Algorithm - house pairs which timed out.",
+                    run_metrics.num_timeouts.load(std::memory_order_relaxed));
+        writeMetric(metrics_file, "myrobot_steps_total", "counter", "Steps simulated so far.", num_steps);
+        writeMetric(metrics_file, "myrobot_steps_per_second", "gauge", "Steps simulated per second, since the previous export.", steps_per_second);
+        writeMetric(metrics_file, "myrobot_active_workers", "gauge", "Live worker threads (including timed out ones still running).",
+                    run_metrics.num_active_workers.load(std::memory_order_relaxed));
+        writeMetric(metrics_file, "myrobot_elapsed_seconds", "gauge", "Time since the run started.", elapsed_seconds);
+        writeMetric(metrics_file, "myrobot_eta_seconds", "gauge", "Estimated time until all pairs are done (NaN until the first one is).", eta_seconds);
+        writeMetric(metrics_file, "myrobot_resident_memory_bytes", "gauge", "Resident memory of the process.", readResidentMemory());
+
+        if (!metrics_file.good())
+        {
+            throw std::runtime_error("Couldn't write metrics file \"" + temporary_path.string() + "\"");
+        }
+    }
+
+    std::filesystem::rename(temporary_path, metrics_path);
+}
+
+void MetricsExporter::exportPeriodically(std::stop_token stop_token)
+{
+    std::unique_lock<std::mutex> lock(stop_mutex);
+
+    while (true)
+    {
+        // Woken up early only once stopped (the final export is written by the destructor)
+        stop_condition.wait_for(lock, stop_token, export_interval, []() { return false; });
+        if (stop_token.stop_requested())
+        {
+            return;
+        }
+
+        try
+        {
+            exportMetrics();
+        }
+
+        catch (const std::exception& exception)
+        {
+            OutputHandler::printError("MetricsExporter", exception.what());
+        }
+    }
+}
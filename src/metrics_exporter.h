@@ -0,0 +1,75 @@
+#ifndef METRICS_EXPORTER_H_
+#define METRICS_EXPORTER_H_
+
+#include "run_metrics.h"
+
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <cstddef>
+#include <filesystem>
+#include <condition_variable>
+
+/**
+ * @brief The MetricsExporter class periodically writes a run's progress into a Prometheus text format file.
+ *
+ * The file is rewritten every export interval (by replacing it, so a reader never sees a partially written file),
+ * e.g. for node_exporter's textfile collector, or just for `watch cat`. A final export is written on destruction.
+ */
+class MetricsExporter
+{
+    static constexpr const auto kDefaultExportInterval = std::chrono::seconds(1);
+    inline static constexpr const char kTemporaryExtension[] = ".tmp";
+
+    const RunMetrics& run_metrics;
+    const std::filesystem::path metrics_path;
+    const std::chrono::steady_clock::duration export_interval;
+
+    std::chrono::steady_clock::time_point last_export_time;    // The time of the previous export (for the steps rate).
+    std::size_t last_num_steps = 0;                             // The number of steps at the previous export.
+
+    std::mutex stop_mutex;
+    std::condition_variable_any stop_condition;                 // Wakes the exporter thread up early (on destruction).
+    std::jthread exporter_thread;
+
+    /**
+     * @brief Reads the resident set size of the process.
+     *
+     * @return The resident memory (in bytes), or 0 if it couldn't be read.
+     */
+    static std::size_t readResidentMemory();
+
+    /**
+     * @brief Writes the current metrics into the metrics file.
+     *
+     * @throws std::runtime_error If the metrics file couldn't be written.
+     */
+    void exportMetrics();
+
+    /**
+     * @brief Exports the metrics every export interval, until stopped.
+     */
+    void exportPeriodically(std::stop_token stop_token);
+
+public:
+    /**
+     * @brief Starts exporting the metrics of a run.
+     *
+     * @param run_metrics The run's counters (must outlive the exporter).
+     * @param metrics_path The path of the metrics file to be (re)written.
+     * @param export_interval The time between exports.
+     */
+    MetricsExporter(const RunMetrics& run_metrics,
+                    const std::filesystem::path& metrics_path,
+                    std::chrono::steady_clock::duration export_interval = kDefaultExportInterval);
+
+    /**
+     * @brief Stops exporting, and writes the final metrics.
+     */
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+};
+
+#endif /* METRICS_EXPORTER_H_ */
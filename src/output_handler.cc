@@ -1,11 +1,16 @@
 #include "output_handler.h"
+#include "trace_recorder.h"
 
+#include <chrono>
 #include <fstream>
+#include <iomanip>
 #include <sstream>
 #include <string>
 
 void OutputHandler::exportToFile(const std::string& file_name, const std::string& message)
 {
+    TraceRecorder::ScopedSpan write_span("output", "write", TraceRecorder::formatArgument("file", file_name));
+
     std::ofstream output_file;
     std::ios_base::openmode mode = output_files.contains(file_name) ? std::ios_base::app : std::ios_base::trunc;
 
@@ -74,5 +79,142 @@ void OutputHandler::exportSummary(const std::map<std::string, std::map<std::stri
         summary << std::endl;
     }
 
-    exportToFile("summary.csv", summary.str());
+    exportToFile(getSummaryFileName(), summary.str());
+}
+
+void OutputHandler::exportTable(const std::string& file_name,
+                                const std::string& header,
+                                const std::map<std::string, std::map<std::string, std::string>>& rows)
+{
+    std::ostringstream table;
+
+    table << header << std::endl;
+
+    for (const auto& algorithm_row : rows)
+    {
+        for (const auto& house_column : algorithm_row.second)
+        {
+            table << algorithm_row.first << "," << house_column.first << "," << house_column.second << std::endl;
+        }
+    }
+
+    exportToFile(file_name, table.str());
+}
+
+void OutputHandler::exportPartialSummary(const std::map<std::string, std::map<std::string, std::size_t>>& scores)
+{
+    std::map<std::string, std::map<std::string, std::string>> rows;
+
+    for (const auto& algorithm_row : scores)
+    {
+        for (const auto& house_column : algorithm_row.second)
+        {
+            rows[algorithm_row.first][house_column.first] = std::to_string(house_column.second);
+        }
+    }
+
+    exportTable(getSummaryFileName(), kPartialSummaryHeader, rows);
+}
+
+void OutputHandler::exportPerformance(const std::map<std::string, std::map<std::string, TaskPerformance>>& performance)
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    std::map<std::string, std::map<std::string, std::string>> rows;
+
+    for (const auto& algorithm_row : performance)
+    {
+        for (const auto& [house_name, task_performance] : algorithm_row.second)
+        {
+            std::ostringstream row;
+            row << std::fixed << std::setprecision(3) \
+                << task_performance.num_steps << "," \
+                << Milliseconds(task_performance.wall_time).count() << "," \
+                << Milliseconds(task_performance.cpu_time).count() << "," \
+                << std::setprecision(0) << task_performance.getStepsPerSecond() << "," \
+                << task_performance.peak_memory_bytes << "," \
+                << task_performance.time_budget.count() << "," \
+                << (task_performance.is_timeout ? "TRUE" : "FALSE");
+
+            rows[algorithm_row.first][house_name] = row.str();
+        }
+    }
+
+    exportPerformance(rows);
+}
+
+void OutputHandler::exportStepLatencies(const std::map<std::string, std::map<std::string, TaskPerformance>>& performance)
+{
+    using Microseconds = std::chrono::duration<double, std::micro>;
+
+    std::map<std::string, std::map<std::string, std::string>> rows;
+
+    for (const auto& algorithm_row : performance)
+    {
+        for (const auto& [house_name, task_performance] : algorithm_row.second)
+        {
+            if (!task_performance.step_latencies.has_value())
+            {
+                continue;
+            }
+
+            const StepLatencySummary& step_latencies = task_performance.step_latencies.value();
+
+            std::ostringstream row;
+            row << std::fixed << std::setprecision(3) \
+                << step_latencies.num_calls << "," \
+                << Microseconds(step_latencies.p50).count() << "," \
+                << Microseconds(step_latencies.p99).count() << "," \
+                << Microseconds(step_latencies.p999).count() << "," \
+                << Microseconds(step_latencies.max).count();
+
+            rows[algorithm_row.first][house_name] = row.str();
+        }
+    }
+
+    if (!rows.empty())
+    {
+        exportStepLatencies(rows);
+    }
+}
+
+void OutputHandler::exportPlannerStats(const std::map<std::string, std::map<std::string, TaskPerformance>>& performance)
+{
+    std::map<std::string, std::map<std::string, std::string>> rows;
+
+    for (const auto& algorithm_row : performance)
+    {
+        for (const auto& [house_name, task_performance] : algorithm_row.second)
+        {
+            if (!task_performance.planner_stats.has_value())
+            {
+                continue;
+            }
+
+            const PlannerStats& planner_stats = task_performance.planner_stats.value();
+
+            std::ostringstream row;
+            row << planner_stats.num_searches << "," \
+                << planner_stats.station_searches << "," \
+                << planner_stats.todo_searches << "," \
+                << planner_stats.reachability_searches << "," \
+                << planner_stats.validity_searches << "," \
+                << planner_stats.target_searches << "," \
+                << planner_stats.nodes_expanded << "," \
+                << planner_stats.path_tree_nodes << "," \
+                << planner_stats.peak_path_tree_nodes;
+
+            for (std::size_t decision_count : planner_stats.decisions)
+            {
+                row << "," << decision_count;
+            }
+
+            rows[algorithm_row.first][house_name] = row.str();
+        }
+    }
+
+    if (!rows.empty())
+    {
+        exportPlannerStats(rows);
+    }
 }
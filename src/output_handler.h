@@ -9,6 +9,8 @@
 #include <filesystem>
 #include <unordered_set>
 
+#include "task_performance.h"
+
 #include "simulator/enum_operators.h"
 #include "simulator/simulator.h"
 #include "simulator/status.h"
@@ -26,6 +28,19 @@ class OutputHandler
     inline static constexpr const char kStatisticsExtension[] = ".txt";
     inline static constexpr const char kErrorExtension[] = ".error";
     inline static constexpr const char kStatisticsSeparator = '-';
+    inline static constexpr const char kSummaryFileName[] = "summary";
+    inline static constexpr const char kPerformanceFileName[] = "performance";
+    inline static constexpr const char kStepLatencyFileName[] = "step_latency";
+    inline static constexpr const char kPlannerStatsFileName[] = "planner_stats";
+    inline static constexpr const char kSummaryExtension[] = ".csv";
+    inline static constexpr const char kShardTagPrefix[] = ".shard-";
+    inline static constexpr const char kShardTagSeparator[] = "-of-";
+    inline static constexpr const char kPartialSummaryHeader[] = "Algo,House,Score";
+    inline static constexpr const char kPerformanceHeader[] = "Algo,House,NumSteps,WallTimeMs,CpuTimeMs,StepsPerSecond,PeakMemoryBytes,TimeBudgetMs,TimedOut";
+    inline static constexpr const char kStepLatencyHeader[] = "Algo,House,NumCalls,P50Us,P99Us,P999Us,MaxUs";
+    inline static constexpr const char kPlannerStatsHeader[] = "Algo,House,Searches,StationSearches,TodoSearches,ReachabilitySearches,ValiditySearches,TargetSearches," \
+                                                               "NodesExpanded,PathTreeNodes,PeakPathTreeNodes," \
+                                                               "FinishDecisions,ChargeDecisions,ReturnDecisions,CleanDecisions,TurnBackDecisions,NoTargetDecisions,TargetDecisions";
 
     inline static constexpr const char kStepsNumField[] = "NumSteps = ";
     inline static constexpr const char kDirtLeftField[] = "\nDirtLeft = ";
@@ -35,6 +50,7 @@ class OutputHandler
     inline static constexpr const char kScoreField[] = "\nScore = ";
 
     inline static std::unordered_set<std::string> output_files;
+    inline static std::string output_tag;   // Tag added to run-wide output file names (distinguishes shards' partial results).
 
     /**
      * @brief Constructs the error file name of a given module (algorithm / house).
@@ -43,7 +59,46 @@ class OutputHandler
      * 
      * @return The constructed error file name.
      */
-    static std::string getErrorFileName(const std::string& module_name) { return module_name + kErrorExtension; }
+    static std::string getErrorFileName(const std::string& module_name) { return module_name + output_tag + kErrorExtension; }
+
+    /**
+     * @brief Constructs the summary file name of the run (tagged by the shard, if there's one).
+     * 
+     * @return The constructed summary file name.
+     */
+    static std::string getSummaryFileName() { return kSummaryFileName + output_tag + kSummaryExtension; }
+
+    /**
+     * @brief Constructs the performance report file name of the run (tagged by the shard, if there's one).
+     * 
+     * @return The constructed performance report file name.
+     */
+    static std::string getPerformanceFileName() { return kPerformanceFileName + output_tag + kSummaryExtension; }
+
+    /**
+     * @brief Constructs the step latency report file name of the run (tagged by the shard, if there's one).
+     * 
+     * @return The constructed step latency report file name.
+     */
+    static std::string getStepLatencyFileName() { return kStepLatencyFileName + output_tag + kSummaryExtension; }
+
+    /**
+     * @brief Constructs the planner stats report file name of the run (tagged by the shard, if there's one).
+     * 
+     * @return The constructed planner stats report file name.
+     */
+    static std::string getPlannerStatsFileName() { return kPlannerStatsFileName + output_tag + kSummaryExtension; }
+
+    /**
+     * @brief Exports a long format table (a row per algorithm - house pair) into a given file.
+     * 
+     * @param file_name The file to export the table into.
+     * @param header The header line of the table.
+     * @param rows The (already formatted) fields of each algorithm - house pair, following the pair's names.
+     */
+    static void exportTable(const std::string& file_name,
+                            const std::string& header,
+                            const std::map<std::string, std::map<std::string, std::string>>& rows);
 
     /**
      * @brief Constructs the output file name of a given algorithm - house pair.
@@ -101,6 +156,37 @@ public:
      */
     static void printMessage(const std::string& message) { std::cout << message << std::endl; }
 
+    /**
+     * @brief Constructs the output tag of a given shard.
+     * 
+     * @param shard_index The zero-based index of the shard.
+     * @param shard_count The total number of shards.
+     * 
+     * @return The constructed shard tag (e.g. `.shard-0-of-4`).
+     */
+    static std::string getShardTag(std::size_t shard_index, std::size_t shard_count)
+    {
+        return kShardTagPrefix + std::to_string(shard_index) + kShardTagSeparator + std::to_string(shard_count);
+    }
+
+    /**
+     * @brief Sets the tag added to run-wide output file names (summary and error files).
+     * 
+     * @param tag The tag to be added (empty for a regular, non sharded, run).
+     */
+    static void setOutputTag(const std::string& tag) { output_tag = tag; }
+
+    /**
+     * @brief Exports an error message into a dedicated `.error` file only (without printing it).
+     */
+    static void exportErrorFile(const std::string& module_name, const std::string& error_message)
+    {
+        if (isError(error_message))
+        {
+            exportToFile(getErrorFileName(module_name), error_message);
+        }
+    }
+
     /**
      * @brief Exports an error message both to console and to a dedicated `.error` message.
      */
@@ -108,7 +194,7 @@ public:
     {
         if (isError(error_message))
         {
-            exportToFile(getErrorFileName(module_name), error_message);
+            exportErrorFile(module_name, error_message);
             printError(module_name, error_message);
         }
     }
@@ -131,6 +217,68 @@ public:
      * @param scores The scores data structure to export the summary from.
      */
     static void exportSummary(const std::map<std::string, std::map<std::string, std::size_t>>& scores);
+
+    /**
+     * @brief Export a shard's partial run summary, in a mergeable (long `algorithm,house,score`) format.
+     * 
+     * @param scores The scores data structure of the shard's tasks.
+     */
+    static void exportPartialSummary(const std::map<std::string, std::map<std::string, std::size_t>>& scores);
+
+    /**
+     * @brief Export the resources usage of all tasks, into a `performance.csv` file (a row per algorithm - house pair).
+     * 
+     * @param performance The performance reports data structure to export (same layout as the scores data structure).
+     */
+    static void exportPerformance(const std::map<std::string, std::map<std::string, TaskPerformance>>& performance);
+
+    /**
+     * @brief Export already formatted performance rows (e.g. merged from shards' partial results) into a `performance.csv` file.
+     * 
+     * @param performance_rows The formatted performance fields of each algorithm - house pair.
+     */
+    static void exportPerformance(const std::map<std::string, std::map<std::string, std::string>>& performance_rows)
+    {
+        exportTable(getPerformanceFileName(), kPerformanceHeader, performance_rows);
+    }
+
+    /**
+     * @brief Export the step call latencies of the timed tasks, into a `step_latency.csv` file (a row per algorithm - house pair).
+     *
+     * Nothing is exported if no task was timed (see Simulator::enableStepTiming()).
+     * 
+     * @param performance The performance reports data structure to export the step latencies from.
+     */
+    static void exportStepLatencies(const std::map<std::string, std::map<std::string, TaskPerformance>>& performance);
+
+    /**
+     * @brief Export already formatted step latency rows (e.g. merged from shards' partial results) into a `step_latency.csv` file.
+     * 
+     * @param step_latency_rows The formatted step latency fields of each algorithm - house pair.
+     */
+    static void exportStepLatencies(const std::map<std::string, std::map<std::string, std::string>>& step_latency_rows)
+    {
+        exportTable(getStepLatencyFileName(), kStepLatencyHeader, step_latency_rows);
+    }
+
+    /**
+     * @brief Export the planner stats of the tasks whose algorithms report them, into a `planner_stats.csv` file (a row per algorithm - house pair).
+     *
+     * Nothing is exported if no algorithm reported its planner stats (see PlannerStatsAlgorithm).
+     * 
+     * @param performance The performance reports data structure to export the planner stats from.
+     */
+    static void exportPlannerStats(const std::map<std::string, std::map<std::string, TaskPerformance>>& performance);
+
+    /**
+     * @brief Export already formatted planner stats rows (e.g. merged from shards' partial results) into a `planner_stats.csv` file.
+     * 
+     * @param planner_stats_rows The formatted planner stats fields of each algorithm - house pair.
+     */
+    static void exportPlannerStats(const std::map<std::string, std::map<std::string, std::string>>& planner_stats_rows)
+    {
+        exportTable(getPlannerStatsFileName(), kPlannerStatsHeader, planner_stats_rows);
+    }
 };
 
 #endif /* OUTPUT_HANDLER_H_ */
@@ -0,0 +1,125 @@
+#include "replayer.h"
+
+#include "input_handler.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <atomic>
+#include <thread>
+
+Step Replayer::ReplayAlgorithm::nextStep()
+{
+    MacroStep macro_step = nextMacroStep();
+    return macro_step.steps.front();
+}
+
+MacroStep Replayer::ReplayAlgorithm::nextMacroStep()
+{
+    MacroStep macro_step;
+
+    if (num_replayed_steps < steps.size())
+    {
+        macro_step.steps = std::span<const Step>(steps).subspan(num_replayed_steps);
+        return macro_step;
+    }
+
+    // A simulation which ran out of steps is finished on the step requested after its last one
+    if (steps.size() >= max_steps)
+    {
+        macro_step.steps = kFinishingSteps;
+        return macro_step;
+    }
+
+    throw std::runtime_error("Step log ended before the simulation finished");
+}
+
+Replayer::Replayer(const std::vector<HouseFile>& house_files,
+                   const std::vector<std::filesystem::path>& log_paths,
+                   std::size_t num_threads)
+    : num_threads(std::max<std::size_t>(1, num_threads))
+{
+    for (const auto& log_path : log_paths)
+    {
+        std::string log_name = log_path.stem().string();
+
+        // House names may contain the separator as well - so the longest matching house name is taken
+        const HouseFile* log_house_file = nullptr;
+        for (const auto& house_file : house_files)
+        {
+            bool is_matching = log_name.size() > house_file.name.size() + 1
+                               && log_name.starts_with(house_file.name)
+                               && kLogNameSeparator == log_name[house_file.name.size()];
+
+            if (is_matching && (nullptr == log_house_file || house_file.name.size() > log_house_file->name.size()))
+            {
+                log_house_file = &house_file;
+            }
+        }
+
+        if (nullptr == log_house_file)
+        {
+            continue;
+        }
+
+        step_logs.push_back({
+            .path = log_path,
+            .algorithm_name = log_name.substr(log_house_file->name.size() + 1),
+            .house_file = log_house_file
+        });
+    }
+
+    results.resize(step_logs.size());
+}
+
+void Replayer::replay(std::size_t log_index)
+{
+    const StepLog& step_log = step_logs[log_index];
+    ReplayResult& result = results[log_index];
+
+    Simulator simulator(*step_log.house_file);
+
+    try
+    {
+        std::vector<Step> steps;
+        InputHandler::readStepLog(step_log.path, steps);
+
+        ReplayAlgorithm algorithm(steps);
+        simulator.setAlgorithm(algorithm);
+        result.score = simulator.run(algorithm);
+
+        if (!algorithm.isFullyReplayed())
+        {
+            throw std::runtime_error("Step log continues after the simulation finished");
+        }
+    }
+
+    catch (const std::exception& exception)
+    {
+        result.score = simulator.getTimeoutScore();
+        result.algorithm_error = "[house=" + step_log.house_file->name + "]" + exception.what() + "\n";
+    }
+
+    result.statistics = simulator.getSimulationStatistics();
+}
+
+void Replayer::run()
+{
+    std::atomic<std::size_t> next_log_index = 0;
+
+    auto replayLogs = [this, &next_log_index]()
+    {
+        for (std::size_t i = next_log_index++; i < step_logs.size(); i = next_log_index++)
+        {
+            replay(i);
+        }
+    };
+
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 1; i < std::min(num_threads, step_logs.size()); i++)
+    {
+        threads.emplace_back(replayLogs);
+    }
+
+    replayLogs();
+}
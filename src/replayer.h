@@ -0,0 +1,126 @@
+#ifndef REPLAYER_H_
+#define REPLAYER_H_
+
+#include "simulator/simulator.h"
+#include "simulator/deserializer.h"
+
+#include "common/abstract_algorithm.h"
+#include "common/macro_step_algorithm.h"
+
+#include <filesystem>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The Replayer class re-scores step logs (`<house>-<algorithm>.txt` output files) with no algorithm in the loop.
+ *
+ * Each log's steps are replayed through a simulator of its house (by a single macro step), which recomputes the
+ * log's statistics and score. Logs are replayed in parallel, over a fixed number of threads.
+ */
+class Replayer
+{
+    /**
+     * @brief A pseudo algorithm, which hands the simulator the steps of a step log.
+     */
+    class ReplayAlgorithm final : public AbstractAlgorithm, public MacroStepAlgorithm
+    {
+        static constexpr const Step kFinishingSteps[] = { Step::Stay };    // Finishes a simulation which ran out of steps.
+
+        const std::vector<Step>& steps;
+        std::size_t max_steps = 0;
+        std::size_t num_replayed_steps = 0;
+
+    public:
+        explicit ReplayAlgorithm(const std::vector<Step>& steps) : steps(steps) {}
+
+        void setMaxSteps(std::size_t max_steps) override { this->max_steps = max_steps; }
+        void setWallsSensor(const WallsSensor&) override {}
+        void setDirtSensor(const DirtSensor&) override {}
+        void setBatteryMeter(const BatteryMeter&) override {}
+
+        /**
+         * @throws std::runtime_error If the step log ended before the simulation finished.
+         */
+        Step nextStep() override;
+
+        /**
+         * @brief Returns all remaining steps of the log.
+         *
+         * @throws std::runtime_error If the step log ended before the simulation finished.
+         */
+        MacroStep nextMacroStep() override;
+
+        void onMacroStepDone(std::size_t num_steps_taken) override { num_replayed_steps += num_steps_taken; }
+
+        /**
+         * @brief Returns whether or not all steps of the log were replayed.
+         */
+        bool isFullyReplayed() const { return num_replayed_steps >= steps.size(); }
+    };
+
+public:
+    /**
+     * @brief A step log to be replayed.
+     */
+    struct StepLog
+    {
+        std::filesystem::path path;
+        std::string algorithm_name;
+        const HouseFile* house_file;
+    };
+
+    /**
+     * @brief The result of a single replay.
+     */
+    struct ReplayResult
+    {
+        SimulationStatistics statistics;
+        std::size_t score = 0;
+        std::string algorithm_error;        // The replay error (if the log is invalid for its house).
+    };
+
+private:
+    inline static constexpr const char kLogNameSeparator = '-';
+
+    std::vector<StepLog> step_logs;
+    std::vector<ReplayResult> results;
+    const std::size_t num_threads;
+
+    /**
+     * @brief Replays a single step log into its result.
+     */
+    void replay(std::size_t log_index);
+
+public:
+    /**
+     * @brief Matches the given step logs to their houses (by the `<house>-<algorithm>` log name).
+     *
+     * Logs which don't match any of the houses are skipped.
+     *
+     * @param house_files The houses the logs were simulated on (must outlive the replayer).
+     * @param log_paths The paths of the step logs.
+     * @param num_threads The number of replaying threads.
+     */
+    Replayer(const std::vector<HouseFile>& house_files, const std::vector<std::filesystem::path>& log_paths, std::size_t num_threads);
+
+    Replayer(const Replayer& replayer) = delete;
+    Replayer& operator=(const Replayer& replayer) = delete;
+
+    /**
+     * @brief Replays all step logs. Returns only after all logs were replayed.
+     */
+    void run();
+
+    /**
+     * @brief Returns the step logs to be replayed.
+     */
+    const std::vector<StepLog>& getStepLogs() const { return step_logs; }
+
+    /**
+     * @brief Returns the result of a given step log (valid after run() returned).
+     */
+    const ReplayResult& getResult(std::size_t log_index) const { return results.at(log_index); }
+};
+
+#endif /* REPLAYER_H_ */
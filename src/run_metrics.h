@@ -0,0 +1,25 @@
+#ifndef RUN_METRICS_H_
+#define RUN_METRICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @brief The RunMetrics struct keeps the live progress counters of a run (see MetricsExporter).
+ *
+ * Counters are updated by the worker threads and sampled by the exporter thread - they are relaxed atomics,
+ * so a sample may be slightly inconsistent (e.g. a task counted as started, but not yet as running).
+ */
+struct RunMetrics
+{
+    const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    std::atomic<std::size_t> num_tasks = 0;         // The number of tasks of the run.
+    std::atomic<std::size_t> num_started = 0;       // The number of tasks whose simulation started.
+    std::atomic<std::size_t> num_finished = 0;      // The number of tasks which finished (gracefully or by a timeout).
+    std::atomic<std::size_t> num_timeouts = 0;      // The number of tasks which timed out.
+    std::atomic<std::size_t> num_steps = 0;         // The number of steps simulated so far (over all tasks).
+    std::atomic<std::size_t> num_active_workers = 0;    // The number of live worker threads (including timed out ones still running).
+};
+
+#endif /* RUN_METRICS_H_ */
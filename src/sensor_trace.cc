@@ -0,0 +1,213 @@
+#include "sensor_trace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    constexpr const char kTraceMagic[] = {'V', 'C', 'T', 'R'};
+    constexpr std::uint32_t kTraceVersion = 1;
+
+    template <typename T>
+    void writeField(std::ofstream& trace_file, T value)
+    {
+        trace_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    T readField(std::ifstream& trace_file)
+    {
+        T value;
+        trace_file.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    }
+
+    template <typename T>
+    T narrowReading(std::size_t reading, const char* reading_name)
+    {
+        if (reading > std::numeric_limits<T>::max())
+        {
+            throw std::out_of_range(std::string("Sensor reading doesn't fit in a trace: ") + reading_name);
+        }
+
+        return static_cast<T>(reading);
+    }
+}
+
+void SensorTrace::save(const std::filesystem::path& trace_path) const
+{
+    std::ofstream trace_file(trace_path, std::ios::binary | std::ios::trunc);
+    if (!trace_file.is_open())
+    {
+        throw std::runtime_error("Couldn't open trace file \"" + trace_path.string() + "\"");
+    }
+
+    trace_file.write(kTraceMagic, sizeof(kTraceMagic));
+    writeField<std::uint32_t>(trace_file, kTraceVersion);
+    writeField<std::uint64_t>(trace_file, max_steps);
+    writeField<std::uint64_t>(trace_file, full_battery);
+    writeField<std::uint64_t>(trace_file, entries.size());
+
+    for (const auto& entry : entries)
+    {
+        writeField<std::uint8_t>(trace_file, entry.wall_mask);
+        writeField<std::uint8_t>(trace_file, entry.dirt_level);
+        writeField<std::uint8_t>(trace_file, static_cast<std::uint8_t>(entry.step));
+        writeField<std::uint32_t>(trace_file, entry.battery_state);
+    }
+
+    if (!trace_file.good())
+    {
+        throw std::runtime_error("Couldn't write trace file \"" + trace_path.string() + "\"");
+    }
+}
+
+SensorTrace SensorTrace::load(const std::filesystem::path& trace_path)
+{
+    std::ifstream trace_file(trace_path, std::ios::binary);
+    if (!trace_file.is_open())
+    {
+        throw std::runtime_error("Couldn't open trace file \"" + trace_path.string() + "\"");
+    }
+
+    char magic[sizeof(kTraceMagic)] = {};
+    trace_file.read(magic, sizeof(magic));
+    if (!std::equal(std::begin(magic), std::end(magic), std::begin(kTraceMagic)) || kTraceVersion != readField<std::uint32_t>(trace_file))
+    {
+        throw std::runtime_error("Invalid trace file \"" + trace_path.string() + "\"");
+    }
+
+    SensorTrace trace;
+    trace.max_steps = readField<std::uint64_t>(trace_file);
+    trace.full_battery = readField<std::uint64_t>(trace_file);
+
+    std::uint64_t num_entries = readField<std::uint64_t>(trace_file);
+    if (!trace_file.good() || num_entries > trace.max_steps + 1)
+    {
+        throw std::runtime_error("Invalid trace file \"" + trace_path.string() + "\"");
+    }
+
+    trace.entries.resize(num_entries);
+    for (auto& entry : trace.entries)
+    {
+        entry.wall_mask = readField<std::uint8_t>(trace_file);
+        entry.dirt_level = readField<std::uint8_t>(trace_file);
+
+        std::uint8_t step = readField<std::uint8_t>(trace_file);
+        if (step > static_cast<std::uint8_t>(Step::Finish))
+        {
+            throw std::runtime_error("Invalid step in trace file \"" + trace_path.string() + "\"");
+        }
+
+        entry.step = static_cast<Step>(step);
+        entry.battery_state = readField<std::uint32_t>(trace_file);
+    }
+
+    if (!trace_file.good())
+    {
+        throw std::runtime_error("Truncated trace file \"" + trace_path.string() + "\"");
+    }
+
+    return trace;
+}
+
+void SensorTraceRecorder::setMaxSteps(std::size_t max_steps)
+{
+    trace.max_steps = max_steps;
+    algorithm->setMaxSteps(max_steps);
+}
+
+void SensorTraceRecorder::setWallsSensor(const WallsSensor& walls_sensor)
+{
+    this->walls_sensor = &walls_sensor;
+    algorithm->setWallsSensor(walls_sensor);
+}
+
+void SensorTraceRecorder::setDirtSensor(const DirtSensor& dirt_sensor)
+{
+    this->dirt_sensor = &dirt_sensor;
+    algorithm->setDirtSensor(dirt_sensor);
+}
+
+void SensorTraceRecorder::setBatteryMeter(const BatteryMeter& battery_meter)
+{
+    this->battery_meter = &battery_meter;
+    trace.full_battery = battery_meter.getBatteryState();
+    algorithm->setBatteryMeter(battery_meter);
+}
+
+Step SensorTraceRecorder::nextStep()
+{
+    SensorTraceEntry entry;
+
+    entry.wall_mask = 0;
+    for (Direction direction : {Direction::North, Direction::East, Direction::South, Direction::West})
+    {
+        entry.wall_mask |= walls_sensor->isWall(direction) ? SurroundingsSensor::getWallBit(direction) : 0;
+    }
+
+    entry.dirt_level = narrowReading<std::uint8_t>(dirt_sensor->dirtLevel(), "dirt level");
+    entry.battery_state = narrowReading<std::uint32_t>(battery_meter->getBatteryState(), "battery state");
+
+    entry.step = algorithm->nextStep();
+    trace.entries.push_back(entry);
+
+    return entry.step;
+}
+
+bool SensorTracePlayer::isWall(Direction direction) const
+{
+    return SurroundingsSensor::isWall(trace.entries.at(current_entry).wall_mask, direction);
+}
+
+int SensorTracePlayer::dirtLevel() const
+{
+    return trace.entries.at(current_entry).dirt_level;
+}
+
+std::size_t SensorTracePlayer::getBatteryState() const
+{
+    if (is_initializing)
+    {
+        return trace.full_battery;
+    }
+
+    return trace.entries.at(current_entry).battery_state;
+}
+
+Surroundings SensorTracePlayer::getSurroundings() const
+{
+    const SensorTraceEntry& entry = trace.entries.at(current_entry);
+
+    return {
+        .wall_mask = entry.wall_mask,
+        .dirt_level = entry.dirt_level,
+        .battery_state = entry.battery_state
+    };
+}
+
+std::size_t SensorTracePlayer::replay(AbstractAlgorithm& algorithm)
+{
+    current_entry = 0;
+    is_initializing = true;
+
+    algorithm.setMaxSteps(trace.max_steps);
+    algorithm.setWallsSensor(*this);
+    algorithm.setDirtSensor(*this);
+    algorithm.setBatteryMeter(*this);
+
+    is_initializing = false;
+
+    for (; current_entry < trace.entries.size(); current_entry++)
+    {
+        if (trace.entries[current_entry].step != algorithm.nextStep())
+        {
+            break;
+        }
+    }
+
+    return current_entry;
+}
@@ -0,0 +1,123 @@
+#ifndef SENSOR_TRACE_H_
+#define SENSOR_TRACE_H_
+
+#include "common/abstract_algorithm.h"
+#include "common/surroundings_sensor.h"
+#include "common/battery_meter.h"
+#include "common/dirt_sensor.h"
+#include "common/wall_sensor.h"
+#include "common/enums.h"
+
+#include <filesystem>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief The sensor readings an algorithm was given before a single step, along with the step it took.
+ */
+struct SensorTraceEntry
+{
+    std::uint8_t wall_mask;                 // The walls around the robot (see SurroundingsSensor::getWallBit()).
+    std::uint8_t dirt_level;                // The dirt level at the robot's position.
+    std::uint32_t battery_state;            // The battery meter reading.
+    Step step;                              // The step the algorithm took.
+};
+
+/**
+ * @brief The SensorTrace struct represents the sensor readings an algorithm saw during a whole simulation.
+ *
+ * A trace is stored in a compact binary file (7 bytes per step, in the machine's byte order):
+ * a `VCTR` magic, a format version, the max steps, the full battery capacity and the number of entries - followed by the entries.
+ */
+struct SensorTrace
+{
+    std::size_t max_steps = 0;              // The simulation's max steps.
+    std::size_t full_battery = 0;           // The battery meter reading when the algorithm was initialized.
+    std::vector<SensorTraceEntry> entries;  // An entry per nextStep() call.
+
+    /**
+     * @brief Writes the trace into a given file.
+     *
+     * @throws std::runtime_error If the file couldn't be written.
+     */
+    void save(const std::filesystem::path& trace_path) const;
+
+    /**
+     * @brief Reads a trace from a given file.
+     *
+     * @throws std::runtime_error If the file couldn't be read, or is not a valid trace file.
+     */
+    static SensorTrace load(const std::filesystem::path& trace_path);
+};
+
+/**
+ * @brief The SensorTraceRecorder class wraps an algorithm, and records the sensor readings it was given into a trace.
+ *
+ * The readings are sampled by the recorder before each step, regardless of which sensors the algorithm samples.
+ * The wrapped algorithm is exposed as a plain AbstractAlgorithm - so it's run (and recorded) step by step.
+ */
+class SensorTraceRecorder final : public AbstractAlgorithm
+{
+    std::unique_ptr<AbstractAlgorithm> algorithm;
+    const WallsSensor* walls_sensor = nullptr;
+    const DirtSensor* dirt_sensor = nullptr;
+    const BatteryMeter* battery_meter = nullptr;
+    SensorTrace trace;
+
+public:
+    explicit SensorTraceRecorder(std::unique_ptr<AbstractAlgorithm> algorithm) : algorithm(std::move(algorithm)) {}
+
+    void setMaxSteps(std::size_t max_steps) override;
+    void setWallsSensor(const WallsSensor& walls_sensor) override;
+    void setDirtSensor(const DirtSensor& dirt_sensor) override;
+    void setBatteryMeter(const BatteryMeter& battery_meter) override;
+
+    /**
+     * @brief Records the current sensor readings, and the wrapped algorithm's next step.
+     *
+     * @throws std::out_of_range If a reading doesn't fit in the trace format.
+     */
+    Step nextStep() override;
+
+    /**
+     * @brief Returns the trace recorded so far.
+     */
+    const SensorTrace& getTrace() const { return trace; }
+};
+
+/**
+ * @brief The SensorTracePlayer class replays a trace's sensor readings into an algorithm, with no simulator in the loop.
+ */
+class SensorTracePlayer final : public WallsSensor, public DirtSensor, public BatteryMeter, public SurroundingsSensor
+{
+    const SensorTrace& trace;
+    std::size_t current_entry = 0;
+    bool is_initializing = true;            // Whether the algorithm is being initialized (so the full battery is read).
+
+public:
+    /**
+     * @param trace The trace to be replayed (must outlive the player).
+     */
+    explicit SensorTracePlayer(const SensorTrace& trace) : trace(trace) {}
+
+    bool isWall(Direction direction) const override;
+    int dirtLevel() const override;
+    std::size_t getBatteryState() const override;
+    Surroundings getSurroundings() const override;
+
+    /**
+     * @brief Replays the trace into a given (newly created) algorithm, calling nextStep() once per entry.
+     *
+     * The replay stops early if the algorithm diverges from the trace (takes a different step than the recorded one),
+     * since the following readings wouldn't match its steps.
+     *
+     * @param algorithm The algorithm to be replayed (not initialized yet).
+     *
+     * @return The number of entries replayed before the algorithm diverged (the number of entries if it didn't).
+     */
+    std::size_t replay(AbstractAlgorithm& algorithm);
+};
+
+#endif /* SENSOR_TRACE_H_ */
@@ -0,0 +1,299 @@
+#include "batch_simulator.h"
+
+#include <time.h>
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+namespace
+{
+    constexpr const std::uint8_t kAllWallsMask = 0xF;       // The wall mask of the padding cells (never occupied by a robot).
+
+    std::chrono::nanoseconds readThreadCpuTime()
+    {
+        timespec cpu_time;
+        if (0 != clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time))
+        {
+            return std::chrono::nanoseconds::zero();
+        }
+
+        return std::chrono::seconds(cpu_time.tv_sec) + std::chrono::nanoseconds(cpu_time.tv_nsec);
+    }
+}
+
+Surroundings BatchSimulator::LaneSensor::getSurroundings() const
+{
+    return {
+        .wall_mask = batch.sampled_wall_masks[lane],
+        .dirt_level = batch.sampled_dirt_levels[lane],
+        .battery_state = batch.batteries[lane].getBatteryState()
+    };
+}
+
+BatchSimulator::BatchSimulator(const std::vector<const HouseFile*>& house_files, const AlgorithmFactory& algorithm_factory)
+{
+    std::size_t num_lanes = house_files.size();
+
+    // The lanes' sensors and batteries are handed to their algorithms by reference - so these are never reallocated
+    lane_sensors.reserve(num_lanes);
+    batteries.reserve(num_lanes);
+
+    for (std::size_t lane = 0; lane < num_lanes; lane++)
+    {
+        const HouseFile& house_file = *house_files[lane];
+
+        layoutHouse(house_file);
+        dirt_counts.push_back(house_file.house.getTotalDirtCount());
+        initial_dirt_counts.push_back(house_file.house.getInitialDirtCount());
+        max_steps.push_back(house_file.max_steps);
+        batteries.push_back(house_file.battery);
+        lane_sensors.emplace_back(*this, lane);
+        running_lanes.push_back(lane);
+    }
+
+    next_steps.assign(num_lanes, Step::Stay);
+    statistics.resize(num_lanes);
+    algorithm_times.assign(num_lanes, std::chrono::nanoseconds::zero());
+    algorithm_cpu_times.assign(num_lanes, std::chrono::nanoseconds::zero());
+    is_timed_out.assign(num_lanes, 0);
+    algorithm_errors.resize(num_lanes);
+    sampled_wall_masks.resize(num_lanes);
+    sampled_dirt_levels.resize(num_lanes);
+
+    // Algorithms may sample their sensors once they're set
+    sampleSensors();
+
+    for (std::size_t lane = 0; lane < num_lanes; lane++)
+    {
+        algorithms.push_back(algorithm_factory());
+
+        AbstractAlgorithm& algorithm = *algorithms.back();
+        algorithm.setMaxSteps(max_steps[lane]);
+        algorithm.setWallsSensor(static_cast<const WallsSensor&>(lane_sensors[lane]));
+        algorithm.setDirtSensor(static_cast<const DirtSensor&>(lane_sensors[lane]));
+        algorithm.setBatteryMeter(static_cast<const BatteryMeter&>(batteries[lane]));
+    }
+}
+
+void BatchSimulator::layoutHouse(const HouseFile& house_file)
+{
+    const House& house = house_file.house;
+
+    std::size_t num_rows = house.getRowsCount();
+    std::size_t num_columns = house.getColumnsCount();
+    std::size_t row_stride = num_columns + 2;
+    std::size_t first_cell = cell_wall_masks.size();
+
+    cell_wall_masks.resize(first_cell + (num_rows + 2) * row_stride, kAllWallsMask);
+    cell_dirt_levels.resize(first_cell + (num_rows + 2) * row_stride, 0);
+
+    auto getCell = [first_cell, row_stride](const Position& position)
+    {
+        return first_cell + (position.first + 1) * row_stride + (position.second + 1);
+    };
+
+    for (int row = 0; row < static_cast<int>(num_rows); row++)
+    {
+        for (int column = 0; column < static_cast<int>(num_columns); column++)
+        {
+            std::uint8_t wall_mask = 0;
+            wall_mask |= house.isWallAt(row - 1, column) ? SurroundingsSensor::getWallBit(Direction::North) : 0;
+            wall_mask |= house.isWallAt(row, column + 1) ? SurroundingsSensor::getWallBit(Direction::East) : 0;
+            wall_mask |= house.isWallAt(row + 1, column) ? SurroundingsSensor::getWallBit(Direction::South) : 0;
+            wall_mask |= house.isWallAt(row, column - 1) ? SurroundingsSensor::getWallBit(Direction::West) : 0;
+
+            std::size_t cell = getCell(Position(row, column));
+            cell_wall_masks[cell] = wall_mask;
+            cell_dirt_levels[cell] = house.getDirtLevelAt(row, column);
+        }
+    }
+
+    robot_cells.push_back(getCell(house.getCurrentPosition()));
+    docking_station_cells.push_back(getCell(house.getDockingStationPosition()));
+    row_strides.push_back(row_stride);
+}
+
+void BatchSimulator::sampleSensors()
+{
+    for (std::size_t lane : running_lanes)
+    {
+        std::size_t cell = robot_cells[lane];
+        sampled_wall_masks[lane] = cell_wall_masks[cell];
+        sampled_dirt_levels[lane] = static_cast<int>(cell_dirt_levels[cell]);
+    }
+}
+
+void BatchSimulator::finishLane(std::size_t lane, Step last_step)
+{
+    statistics[lane].score = Simulator::computeScore(last_step,
+                                                     statistics[lane].num_steps_taken,
+                                                     max_steps[lane],
+                                                     dirt_counts[lane],
+                                                     robot_cells[lane] == docking_station_cells[lane],
+                                                     batteries[lane].isBatteryExhausted());
+}
+
+bool BatchSimulator::takeStep(std::size_t lane, Step next_step)
+{
+    SimulationStatistics& lane_statistics = statistics[lane];
+    if (lane_statistics.num_steps_taken == max_steps[lane] && Step::Finish != next_step)
+    {
+        finishLane(lane, next_step);
+        return true;
+    }
+
+    lane_statistics.step_history.push_back(next_step);
+
+    std::size_t& robot_cell = robot_cells[lane];
+    if (Step::Finish == next_step)
+    {
+        lane_statistics.mission_status = (robot_cell == docking_station_cells[lane]) ? Status::Finished : Status::Dead;
+        finishLane(lane, next_step);
+        return true;
+    }
+
+    /* If no battery left - discharge() throws an Empty Battery exception */
+    Battery& battery = batteries[lane];
+    if (Step::Stay == next_step)
+    {
+        if (robot_cell == docking_station_cells[lane])
+        {
+            battery.charge();
+        }
+
+        else
+        {
+            battery.discharge();
+
+            if (0 != cell_dirt_levels[robot_cell])
+            {
+                cell_dirt_levels[robot_cell]--;
+                dirt_counts[lane]--;
+            }
+        }
+    }
+
+    else
+    {
+        battery.discharge();
+
+        Direction direction = static_cast<Direction>(next_step); // Safe due to prior checks
+        if (SurroundingsSensor::isWall(cell_wall_masks[robot_cell], direction))
+        {
+            throw std::out_of_range("Cannot move into a wall!");
+        }
+
+        std::size_t row_stride = row_strides[lane];
+        switch (direction)
+        {
+            case Direction::North: robot_cell -= row_stride; break;
+            case Direction::East: robot_cell += 1; break;
+            case Direction::South: robot_cell += row_stride; break;
+            case Direction::West: robot_cell -= 1; break;
+        }
+    }
+
+    lane_statistics.num_steps_taken++;
+
+    if (robot_cell != docking_station_cells[lane] && battery.isBatteryExhausted())
+    {
+        lane_statistics.mission_status = Status::Dead;
+        finishLane(lane, next_step);
+        return true;
+    }
+
+    return false;
+}
+
+void BatchSimulator::run()
+{
+    while (!running_lanes.empty())
+    {
+        sampleSensors();
+
+        // Each lane's call ends where the next one starts - so the thread's CPU clock is read once per call
+        std::chrono::nanoseconds start_cpu_time = readThreadCpuTime();
+
+        for (std::size_t lane : running_lanes)
+        {
+            std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+            try
+            {
+                next_steps[lane] = algorithms[lane]->nextStep();
+            }
+
+            catch (const std::exception& exception)
+            {
+                algorithm_errors[lane] = exception.what();
+            }
+
+            algorithm_times[lane] += std::chrono::steady_clock::now() - start_time;
+
+            std::chrono::nanoseconds end_cpu_time = readThreadCpuTime();
+            algorithm_cpu_times[lane] += end_cpu_time - start_cpu_time;
+            start_cpu_time = end_cpu_time;
+        }
+
+        std::erase_if(running_lanes, [this](std::size_t lane)
+        {
+            if (!algorithm_errors[lane].empty())
+            {
+                return true;
+            }
+
+            try
+            {
+                if (takeStep(lane, next_steps[lane]))
+                {
+                    return true;
+                }
+            }
+
+            catch (const std::exception& exception)
+            {
+                algorithm_errors[lane] = exception.what();
+                return true;
+            }
+
+            // The lane's time budget is MaxSteps milliseconds (as a Task's)
+            if (algorithm_times[lane] >= std::chrono::milliseconds(max_steps[lane]))
+            {
+                is_timed_out[lane] = 1;
+                return true;
+            }
+
+            return false;
+        });
+    }
+}
+
+const SimulationStatistics& BatchSimulator::getSimulationStatistics(std::size_t lane)
+{
+    SimulationStatistics& lane_statistics = statistics.at(lane);
+    lane_statistics.dirt_left = dirt_counts[lane];
+    lane_statistics.is_at_docking_station = (robot_cells[lane] == docking_station_cells[lane]);
+    return lane_statistics;
+}
+
+std::size_t BatchSimulator::getScore(std::size_t lane) const
+{
+    if (isTimedOut(lane) || !algorithm_errors.at(lane).empty())
+    {
+        return Simulator::computeTimeoutScore(max_steps[lane], initial_dirt_counts[lane]);
+    }
+
+    return statistics.at(lane).score;
+}
+
+std::optional<PlannerStats> BatchSimulator::getPlannerStats(std::size_t lane) const
+{
+    const PlannerStatsAlgorithm* planner_stats_algorithm = dynamic_cast<const PlannerStatsAlgorithm*>(algorithms.at(lane).get());
+    if (nullptr == planner_stats_algorithm)
+    {
+        return std::nullopt;
+    }
+
+    return planner_stats_algorithm->getPlannerStats();
+}
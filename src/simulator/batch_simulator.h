@@ -0,0 +1,165 @@
+#ifndef BATCH_SIMULATOR_H_
+#define BATCH_SIMULATOR_H_
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <optional>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "common/AlgorithmRegistrar.h"
+#include "common/abstract_algorithm.h"
+#include "common/planner_stats_algorithm.h"
+#include "common/surroundings_sensor.h"
+#include "common/dirt_sensor.h"
+#include "common/wall_sensor.h"
+#include "common/enums.h"
+
+#include "deserializer.h"
+#include "simulator.h"
+#include "battery.h"
+
+/**
+ * @brief The BatchSimulator class simulates a group of houses in lockstep, each by its own instance of a single algorithm.
+ *
+ * Each house is a lane of the batch. On each round, the sensors of all running lanes are sampled, each lane's algorithm
+ * suggests its next step, and the steps of all lanes are taken - with the same rules (and scores) as a Simulator's.
+ *
+ * The houses' state is laid out structure-of-arrays: the lanes' grids are flattened (and padded by a wall border) into
+ * shared cell arrays, and each lane's robot state is an entry of per-lane arrays - so sampling the sensors and taking
+ * the steps of a round are tight loops over the lanes, rather than a per-simulation call chain.
+ *
+ * Lanes can't be preempted: each lane is charged with the (wall-clock) time of its own algorithm calls, and is timed out
+ * once it outruns its time budget (MaxSteps milliseconds) - but an algorithm stuck in a single call stalls the whole batch.
+ */
+class BatchSimulator
+{
+    /**
+     * @brief The sensors of a single lane - reading the lane's sampled state (see sampleSensors()).
+     */
+    class LaneSensor final : public WallsSensor, public DirtSensor, public SurroundingsSensor
+    {
+        const BatchSimulator& batch;
+        std::size_t lane;
+
+    public:
+        LaneSensor(const BatchSimulator& batch, std::size_t lane) : batch(batch), lane(lane) {}
+
+        bool isWall(Direction direction) const override { return SurroundingsSensor::isWall(batch.sampled_wall_masks[lane], direction); }
+        int dirtLevel() const override { return batch.sampled_dirt_levels[lane]; }
+        Surroundings getSurroundings() const override;
+    };
+
+    /* House layout - the lanes' grids, flattened one after the other (each padded by a wall border) */
+    std::vector<std::uint8_t> cell_wall_masks;              // The walls around each cell (see SurroundingsSensor::getWallBit()).
+    std::vector<unsigned int> cell_dirt_levels;             // The dirt level of each cell.
+
+    /* Lane state - an entry per lane */
+    std::vector<std::size_t> robot_cells;                   // The robot's cell.
+    std::vector<std::size_t> docking_station_cells;         // The docking station's cell.
+    std::vector<std::size_t> row_strides;                   // The number of cells in a row of the lane's (padded) grid.
+    std::vector<std::size_t> dirt_counts;                   // The total dirt left in the lane's house.
+    std::vector<std::size_t> initial_dirt_counts;           // The initial total dirt of the lane's house.
+    std::vector<std::size_t> max_steps;                     // The lane's maximal number of steps.
+    std::vector<Battery> batteries;                         // The lanes' batteries (serving as their battery meters).
+    std::vector<Step> next_steps;                           // The steps suggested on the current round.
+    std::vector<SimulationStatistics> statistics;           // The lanes' statistics (some fields are computed on demand).
+    std::vector<std::chrono::nanoseconds> algorithm_times;  // The time charged to the lane's algorithm calls.
+    std::vector<std::chrono::nanoseconds> algorithm_cpu_times;  // The (thread) CPU time consumed by the lane's algorithm calls.
+    std::vector<std::uint8_t> is_timed_out;                 // Whether the lane was timed out.
+    std::vector<std::string> algorithm_errors;              // The error which ended the lane's simulation (if any).
+
+    /* Sampled sensors - an entry per lane (valid during the lane's algorithm calls) */
+    std::vector<std::uint8_t> sampled_wall_masks;
+    std::vector<int> sampled_dirt_levels;
+
+    std::vector<LaneSensor> lane_sensors;
+    std::vector<std::unique_ptr<AbstractAlgorithm>> algorithms;
+    std::vector<std::size_t> running_lanes;                 // The lanes which are not finished yet.
+
+    /**
+     * @brief Lays out a lane's house grid at the end of the cell arrays.
+     */
+    void layoutHouse(const HouseFile& house_file);
+
+    /**
+     * @brief Samples the sensors of all running lanes.
+     */
+    void sampleSensors();
+
+    /**
+     * @brief Takes a lane's next step (with the same rules as Simulator).
+     *
+     * @returns Whether or not the lane's simulation is finished.
+     *
+     * @throws std::range_error If the robot's battery is empty.
+     * @throws std::out_of_range If the robot moved into a wall.
+     */
+    bool takeStep(std::size_t lane, Step next_step);
+
+    /**
+     * @brief Computes a finished lane's score.
+     */
+    void finishLane(std::size_t lane, Step last_step);
+
+public:
+    /**
+     * @brief Creates a batch of houses, and an instance of the algorithm for each of them.
+     *
+     * @param house_files The houses to be simulated (a lane per house).
+     * @param algorithm_factory The factory of the algorithm to be run on all houses.
+     */
+    BatchSimulator(const std::vector<const HouseFile*>& house_files, const AlgorithmFactory& algorithm_factory);
+
+    BatchSimulator(const BatchSimulator& batch_simulator) = delete;
+    BatchSimulator& operator=(const BatchSimulator& batch_simulator) = delete;
+
+    /**
+     * @brief Runs all lanes until they're finished (gracefully, by an error or by a timeout).
+     */
+    void run();
+
+    /**
+     * @brief Returns the number of lanes (houses) in the batch.
+     */
+    std::size_t getNumLanes() const { return statistics.size(); }
+
+    /**
+     * @brief Returns a lane's simulation statistics report.
+     */
+    const SimulationStatistics& getSimulationStatistics(std::size_t lane);
+
+    /**
+     * @brief Returns a lane's score (its Timeout score, if it was ended by an error or a timeout).
+     */
+    std::size_t getScore(std::size_t lane) const;
+
+    /**
+     * @brief Returns the error which ended a lane's simulation (empty if it had none).
+     */
+    const std::string& getAlgorithmError(std::size_t lane) const { return algorithm_errors.at(lane); }
+
+    /**
+     * @brief Returns whether or not a lane was timed out.
+     */
+    bool isTimedOut(std::size_t lane) const { return 0 != is_timed_out.at(lane); }
+
+    /**
+     * @brief Returns the time charged to a lane's algorithm calls.
+     */
+    std::chrono::nanoseconds getAlgorithmTime(std::size_t lane) const { return algorithm_times.at(lane); }
+
+    /**
+     * @brief Returns the (thread) CPU time consumed by a lane's algorithm calls.
+     */
+    std::chrono::nanoseconds getAlgorithmCpuTime(std::size_t lane) const { return algorithm_cpu_times.at(lane); }
+
+    /**
+     * @brief Returns a lane's algorithm planner stats (if it implements the PlannerStatsAlgorithm interface).
+     */
+    std::optional<PlannerStats> getPlannerStats(std::size_t lane) const;
+};
+
+#endif /* BATCH_SIMULATOR_H_ */
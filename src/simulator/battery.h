@@ -12,7 +12,7 @@
  *
  * It inherits from the BatteryMeter class and provides functionality to charge and discharge the battery.
  */
-class Battery : public BatteryMeter
+class Battery final : public BatteryMeter
 {
     static constexpr const float kEmptyBatteryLevel = 0.0f;  // Empty battery level (in steps).
     static constexpr const float kStepsToFullAmount = 20.0f; // Charging duration (in steps).
@@ -27,6 +27,14 @@ public:
     Battery(const Battery& battery) = default;
     Battery& operator=(const Battery& battery) = default;
 
+    /**
+     * @brief Compares the exact battery states (not just their meter readings).
+     */
+    bool operator==(const Battery& battery) const
+    {
+        return full_amount == battery.full_amount && current_amount == battery.current_amount;
+    }
+
     /**
      * @brief Constructs a new Battery object with the specified full amount of the battery.
      *
@@ -44,6 +52,16 @@ public:
         return kEmptyBatteryLevel == std::floor(current_amount);
     }
 
+    /**
+     * @brief Determines whether the battery is fully charged or not.
+     *
+     * @return True if battery is full, false otherwise.
+     */
+    bool isFull() const
+    {
+        return full_amount == current_amount;
+    }
+
     /**
      * @brief Charges the battery by increasing the current amount.
      *
@@ -4,7 +4,7 @@
 
 void House::computeTotalDirtCount()
 {
-    for (const auto& row : dirt_map)
+    for (const auto& row : *dirt_map)
     {
         for (unsigned int dirt : row)
         {
@@ -18,8 +18,8 @@ void House::computeTotalDirtCount()
 House::House(std::vector<std::vector<bool>>&& wall_map,
              std::vector<std::vector<unsigned int>>&& dirt_map,
              const Position& docking_station_position)
-            : wall_map(std::move(wall_map)),
-              dirt_map(std::move(dirt_map)),
+            : wall_map(std::make_shared<const WallMap>(std::move(wall_map))),
+              dirt_map(std::make_shared<DirtMap>(std::move(dirt_map))),
               current_position(docking_station_position),
               docking_station_position(docking_station_position),
               total_dirt_count(0)
@@ -27,6 +27,65 @@ House::House(std::vector<std::vector<bool>>&& wall_map,
     computeTotalDirtCount();
 }
 
+House::House(const House& house)
+            : wall_map(house.wall_map),
+              dirt_map(house.dirt_map),
+              current_position(house.current_position),
+              docking_station_position(house.docking_station_position),
+              total_dirt_count(house.total_dirt_count),
+              initial_dirt_count(house.initial_dirt_count),
+              battery_meter(house.battery_meter),
+              is_dirt_map_owned(false)
+{
+    house.is_dirt_map_owned.store(false, std::memory_order_relaxed);
+}
+
+House& House::operator=(const House& house)
+{
+    if (this != &house)
+    {
+        wall_map = house.wall_map;
+        dirt_map = house.dirt_map;
+        current_position = house.current_position;
+        docking_station_position = house.docking_station_position;
+        total_dirt_count = house.total_dirt_count;
+        initial_dirt_count = house.initial_dirt_count;
+        battery_meter = house.battery_meter;
+        is_dirt_map_owned.store(false, std::memory_order_relaxed);
+        house.is_dirt_map_owned.store(false, std::memory_order_relaxed);
+    }
+
+    return *this;
+}
+
+House::House(House&& house) noexcept
+            : wall_map(std::move(house.wall_map)),
+              dirt_map(std::move(house.dirt_map)),
+              current_position(house.current_position),
+              docking_station_position(house.docking_station_position),
+              total_dirt_count(house.total_dirt_count),
+              initial_dirt_count(house.initial_dirt_count),
+              battery_meter(house.battery_meter),
+              is_dirt_map_owned(house.is_dirt_map_owned.load(std::memory_order_relaxed))
+{}
+
+House& House::operator=(House&& house) noexcept
+{
+    if (this != &house)
+    {
+        wall_map = std::move(house.wall_map);
+        dirt_map = std::move(house.dirt_map);
+        current_position = house.current_position;
+        docking_station_position = house.docking_station_position;
+        total_dirt_count = house.total_dirt_count;
+        initial_dirt_count = house.initial_dirt_count;
+        battery_meter = house.battery_meter;
+        is_dirt_map_owned.store(house.is_dirt_map_owned.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    return *this;
+}
+
 template <typename T>
 bool House::isOutOfBounds(const std::vector<std::vector<T>>& map, const Position& position)
 {
@@ -53,12 +112,24 @@ template bool House::isOutOfBounds<unsigned int>(const std::vector<std::vector<u
 
 int House::dirtLevel() const
 {
-    if (isOutOfBounds(dirt_map, current_position))
+    if (isOutOfBounds(*dirt_map, current_position))
     {
         throw std::out_of_range("Robot sampled dirt level outside of the house grid!");
     }
 
-    return dirt_map[current_position.first][current_position.second];
+    return (*dirt_map)[current_position.first][current_position.second];
+}
+
+House::DirtMap& House::getWritableDirtMap()
+{
+    // An explicit flag rather than use_count() - which doesn't synchronize with another thread dropping its copy
+    if (!is_dirt_map_owned.load(std::memory_order_relaxed))
+    {
+        dirt_map = std::make_shared<DirtMap>(*dirt_map);
+        is_dirt_map_owned.store(true, std::memory_order_relaxed);
+    }
+
+    return *dirt_map;
 }
 
 void House::cleanCurrentPosition()
@@ -68,21 +139,47 @@ void House::cleanCurrentPosition()
         return;
     }
 
-    dirt_map[current_position.first][current_position.second] -= kDirtCleaningUnit;
+    getWritableDirtMap()[current_position.first][current_position.second] -= kDirtCleaningUnit;
     total_dirt_count -= kDirtCleaningUnit;
 }
 
+bool House::isWallAt(int row, int column) const
+{
+    if (row < 0 || column < 0 || static_cast<std::size_t>(row) >= wall_map->size())
+    {
+        return true;
+    }
+
+    const std::vector<bool>& wall_row = (*wall_map)[row];
+    if (static_cast<std::size_t>(column) >= wall_row.size())
+    {
+        return true;
+    }
+
+    return wall_row[column];
+}
+
+unsigned int House::getDirtLevelAt(int row, int column) const
+{
+    if (isOutOfBounds(*dirt_map, Position(row, column)))
+    {
+        return 0;
+    }
+
+    return (*dirt_map)[row][column];
+}
+
 bool House::isWall(Direction direction) const
 {
     Position suggested_position = Position::computePosition(current_position, direction);
 
-    if (isOutOfBounds(wall_map, suggested_position))
+    if (isOutOfBounds(*wall_map, suggested_position))
     {
         // Off-grid positions are considered a wall
         return true;
     }
 
-    return wall_map[suggested_position.first][suggested_position.second];
+    return (*wall_map)[suggested_position.first][suggested_position.second];
 }
 
 void House::move(Step step)
@@ -100,3 +197,27 @@ void House::move(Step step)
 
     current_position = Position::computePosition(current_position, direction);
 }
+
+Surroundings House::getSurroundings() const
+{
+    if (nullptr == battery_meter)
+    {
+        throw std::logic_error("House::getSurroundings() was called before attaching a battery meter.");
+    }
+
+    int row = current_position.first;
+    int column = current_position.second;
+
+    // Checked directly (rather than by isWall()) to avoid computing each adjacent position
+    std::uint8_t wall_mask = 0;
+    wall_mask |= isWallAt(row - 1, column) ? getWallBit(Direction::North) : 0;
+    wall_mask |= isWallAt(row, column + 1) ? getWallBit(Direction::East) : 0;
+    wall_mask |= isWallAt(row + 1, column) ? getWallBit(Direction::South) : 0;
+    wall_mask |= isWallAt(row, column - 1) ? getWallBit(Direction::West) : 0;
+
+    return {
+        .wall_mask = wall_mask,
+        .dirt_level = dirtLevel(),
+        .battery_state = battery_meter->getBatteryState()
+    };
+}
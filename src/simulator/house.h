@@ -1,9 +1,12 @@
 #ifndef HOUSE_H_
 #define HOUSE_H_
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
+#include "common/surroundings_sensor.h"
+#include "common/battery_meter.h"
 #include "common/dirt_sensor.h"
 #include "common/wall_sensor.h"
 #include "common/position.h"
@@ -13,17 +16,28 @@
  * @brief The House class represents the house by means of cleaning operations and house state at robot's current location.
  *
  * It keeps track of the wall map, dirt map, current position, docking station position, and total dirt count.
+ * Once a battery meter is attached, it also serves as a surroundings sensor (sampling the battery meter as well).
+ *
+ * Copies of a house share its maps: the wall map never changes, and the dirt map is copied on the first cleaning
+ * of a shared map (copy-on-write) - so copying a house (e.g. for a simulator snapshot) is cheap.
+ * A house which ever shared its dirt map copies it before cleaning (even if its other copies are gone by then),
+ * so houses sharing a map may be used by different threads (as long as each house is used by a single thread).
  */
-class House : public WallsSensor, public DirtSensor
+class House final : public WallsSensor, public DirtSensor, public SurroundingsSensor
 {
     static constexpr const unsigned int kDirtCleaningUnit = 1;        // Units of dirt to clean when cleaning a position
 
-    std::vector<std::vector<bool>> wall_map;                          // The map representing the walls in the environment.
-    std::vector<std::vector<unsigned int>> dirt_map;                  // The map representing the dirt levels in the environment.
+    using WallMap = std::vector<std::vector<bool>>;
+    using DirtMap = std::vector<std::vector<unsigned int>>;
+
+    std::shared_ptr<const WallMap> wall_map = std::make_shared<const WallMap>();  // The map representing the walls in the environment (shared by all copies).
+    std::shared_ptr<DirtMap> dirt_map = std::make_shared<DirtMap>();              // The map representing the dirt levels in the environment (copy-on-write).
     Position current_position;                                        // The current position of the vacuum cleaner.
     Position docking_station_position;                                // The position of the docking station.
     std::size_t total_dirt_count;                                     // The total count of dirt in the environment.
     std::size_t initial_dirt_count;                                   // The initial total count of dirt (used for scoring)
+    const BatteryMeter* battery_meter = nullptr;                      // The battery meter sampled by getSurroundings() (if attached).
+    mutable std::atomic<bool> is_dirt_map_owned = true;               // Whether the dirt map was never shared (so it may be cleaned in place).
 
     /**
      * @brief Computes the total dirt count in the house.
@@ -41,14 +55,25 @@ class House : public WallsSensor, public DirtSensor
      */
     template <typename T> static bool isOutOfBounds(const std::vector<std::vector<T>>& map, const Position& position);
 
+    /**
+     * @brief Returns the dirt map for modification - copying it first if it's shared with another house.
+     */
+    DirtMap& getWritableDirtMap();
+
 public:
     House() = default;
 
-    House(const House& house) = default;
-    House& operator=(const House& house) = default;
+    /**
+     * @brief Copies a house, sharing its maps (neither house cleans the shared dirt map in place afterwards).
+     *
+     * The copied house is marked as sharing its dirt map (atomically) - so a house may be copied by several threads
+     * at once (e.g. a house file's house, or a simulator snapshot's).
+     */
+    House(const House& house);
+    House& operator=(const House& house);
 
-    House(House&& house) noexcept = default;
-    House& operator=(House&& house) noexcept = default;
+    House(House&& house) noexcept;
+    House& operator=(House&& house) noexcept;
 
     /**
      * @brief Constructs a new House object.
@@ -88,6 +113,36 @@ public:
      */
     void move(Step);
 
+    /**
+     * @brief Gets the current position of the vacuum cleaner.
+     */
+    const Position& getCurrentPosition() const { return current_position; }
+
+    /**
+     * @brief Gets the position of the docking station.
+     */
+    const Position& getDockingStationPosition() const { return docking_station_position; }
+
+    /**
+     * @brief Gets the number of rows of the house grid.
+     */
+    std::size_t getRowsCount() const { return wall_map->size(); }
+
+    /**
+     * @brief Gets the number of columns of the house grid.
+     */
+    std::size_t getColumnsCount() const { return wall_map->empty() ? 0 : wall_map->front().size(); }
+
+    /**
+     * @brief Checks if there is a wall at a given position (off-grid positions are considered a wall).
+     */
+    bool isWallAt(int row, int column) const;
+
+    /**
+     * @brief Gets the dirt level at a given position (off-grid positions have no dirt).
+     */
+    unsigned int getDirtLevelAt(int row, int column) const;
+
     /**
      * @brief Checks if the vacuum cleaner is at the docking station.
      *
@@ -110,6 +165,22 @@ public:
      * @return true if there is a wall, false otherwise.
      */
     bool isWall(Direction) const override;
+
+    /**
+     * @brief Attaches the battery meter to be sampled by getSurroundings().
+     *
+     * @param battery_meter The battery meter (must outlive the house, or be re-attached).
+     */
+    void attachBatteryMeter(const BatteryMeter& battery_meter) { this->battery_meter = &battery_meter; }
+
+    /**
+     * @brief Samples the walls around the current position, its dirt level and the attached battery meter at once.
+     *
+     * @throws std::logic_error If no battery meter was attached.
+     * @throws std::out_of_range If tried to sample dirt level out of the house representation range.
+     * @return The current sensor readings.
+     */
+    Surroundings getSurroundings() const override;
 };
 
 #endif /* HOUSE_H_ */
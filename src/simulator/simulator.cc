@@ -2,12 +2,16 @@
 
 #include <string>
 #include <fstream>
+#include <algorithm>
+#include <stdexcept>
 #include <iostream>
 
 #include "enum_operators.h"
 #include "deserializer.h"
 #include "status.h"
 
+#include "common/tracepoints.h"
+
 Simulator::Simulator(const HouseFile& house_file)
     : max_simulator_steps(house_file.max_steps),
       house(house_file.house),
@@ -37,6 +41,8 @@ void Simulator::updateMissionStatus(Step next_step)
 
 void Simulator::move(Step next_step)
 {
+    VACUUM_TRACEPOINT3(step, statistics.num_steps_taken, static_cast<int>(next_step), battery.getBatteryState());
+
     statistics.step_history.emplace_back(next_step);
 
     if (Step::Finish == next_step)
@@ -71,11 +77,96 @@ void Simulator::move(Step next_step)
     updateMissionStatus(next_step);
 }
 
+const SimulationStatistics& Simulator::getSimulationStatistics()
+{
+    if (nullptr != step_history_prefix)
+    {
+        std::vector<const StepHistorySegment*> segments;
+        std::size_t num_prefix_steps = 0;
+        for (const StepHistorySegment* segment = step_history_prefix.get(); nullptr != segment; segment = segment->prefix.get())
+        {
+            segments.push_back(segment);
+            num_prefix_steps += segment->steps.size();
+        }
+
+        std::vector<Step> step_history;
+        step_history.reserve(num_prefix_steps + statistics.step_history.size());
+        for (auto segment = segments.rbegin(); segment != segments.rend(); segment++)
+        {
+            step_history.insert(step_history.end(), (*segment)->steps.begin(), (*segment)->steps.end());
+        }
+
+        step_history.insert(step_history.end(), statistics.step_history.begin(), statistics.step_history.end());
+
+        statistics.step_history = std::move(step_history);
+        step_history_prefix.reset();
+    }
+
+    statistics.dirt_left = house.getTotalDirtCount();
+    statistics.is_at_docking_station = house.isAtDockingStation();
+    return statistics;
+}
+
+SimulatorSnapshot Simulator::takeSnapshot()
+{
+    if (SimulatorState::Finished == state)
+    {
+        throw std::logic_error("Simulator::takeSnapshot() was called after the simulation finished.");
+    }
+
+    if (!isSnapshotReady())
+    {
+        throw std::logic_error("Simulator::takeSnapshot() was called while the robot isn't docked with a full battery.");
+    }
+
+    if (!statistics.step_history.empty())
+    {
+        step_history_prefix = std::make_shared<const StepHistorySegment>(StepHistorySegment{
+            .prefix = std::move(step_history_prefix),
+            .steps = std::move(statistics.step_history)
+        });
+
+        statistics.step_history.clear();
+    }
+
+    return {
+        .house = house,
+        .battery = battery,
+        .statistics = statistics,
+        .step_history = step_history_prefix,
+        .max_simulator_steps = max_simulator_steps
+    };
+}
+
+void Simulator::restoreSnapshot(const SimulatorSnapshot& snapshot)
+{
+    if (SimulatorState::NoAlgorithm != state)
+    {
+        throw std::logic_error("Simulator::restoreSnapshot() was called after Simulator::setAlgorithm().");
+    }
+
+    // The restoring algorithm takes its start as the docking station, and its first battery reading as full capacity.
+    if (!snapshot.house.isAtDockingStation() || !snapshot.battery.isFull())
+    {
+        throw std::logic_error("Simulator::restoreSnapshot() was called with a snapshot whose robot isn't docked with a full battery.");
+    }
+
+    house = snapshot.house;
+    battery = snapshot.battery;
+    statistics = snapshot.statistics;
+    step_history_prefix = snapshot.step_history;
+    max_simulator_steps = snapshot.max_simulator_steps;
+}
+
 void Simulator::setAlgorithm(AbstractAlgorithm& chosen_algorithm)
 {
     algorithm = &chosen_algorithm;
+    macro_step_algorithm = dynamic_cast<MacroStepAlgorithm*>(algorithm);
+    planner_stats_algorithm = dynamic_cast<const PlannerStatsAlgorithm*>(algorithm);
 
-    algorithm->setMaxSteps(max_simulator_steps);
+    house.attachBatteryMeter(static_cast<const BatteryMeter&>(battery));
+
+    algorithm->setMaxSteps(max_simulator_steps - statistics.num_steps_taken);
     algorithm->setWallsSensor(static_cast<const WallsSensor&>(house));
     algorithm->setDirtSensor(static_cast<const DirtSensor&>(house));
     algorithm->setBatteryMeter(static_cast<const BatteryMeter&>(battery));
@@ -83,59 +174,220 @@ void Simulator::setAlgorithm(AbstractAlgorithm& chosen_algorithm)
     state = SimulatorState::Ready;
 }
 
-void Simulator::calculateScore(Step last_step)
+std::size_t Simulator::computeScore(Step last_step,
+                                   std::size_t num_steps_taken,
+                                   std::size_t max_steps,
+                                   std::size_t dirt_left,
+                                   bool is_at_docking_station,
+                                   bool is_battery_exhausted)
 {
-    std::size_t steps = statistics.num_steps_taken;
+    std::size_t steps = num_steps_taken;
 
     std::size_t penalty = 0;
-    if (isDeadScoring(last_step))
+    if (Step::Finish != last_step && is_battery_exhausted && !is_at_docking_station)
     {
-        steps = max_simulator_steps;
+        // Dead robot
+        steps = max_steps;
         penalty = kDeadPenalty;
     }
 
-    else if (isLyingScoring(last_step))
+    else if (Step::Finish == last_step && !is_at_docking_station)
     {
-        steps = max_simulator_steps;
+        // Lying algorithm
+        steps = max_steps;
         penalty = kLyingPenalty;
     }
 
-    else if (!house.isAtDockingStation())
+    else if (!is_at_docking_station)
     {
         penalty = kNotInDockPenalty;
     }
 
-    statistics.score = steps + house.getTotalDirtCount() * kDirtFactor + penalty;
+    return steps + dirt_left * kDirtFactor + penalty;
 }
 
-std::size_t Simulator::run()
+void Simulator::calculateScore(Step last_step)
 {
-    if (SimulatorState::Ready != state)
+    statistics.score = computeScore(last_step,
+                                    statistics.num_steps_taken,
+                                    max_simulator_steps,
+                                    house.getTotalDirtCount(),
+                                    house.isAtDockingStation(),
+                                    battery.isBatteryExhausted());
+}
+
+void Simulator::finish()
+{
+    calculateScore(last_step);
+    state = SimulatorState::Finished;
+}
+
+std::size_t Simulator::detectCycle()
+{
+    // Dirt is only ever cleaned - so an unchanged dirt count means no dirt was cleaned since the samples were taken
+    if (house.getTotalDirtCount() != cycle_dirt_count)
     {
-        throw std::logic_error("Called Simulator::run() before calling Simulator::setAlgorithm()");
+        cycle_samples.clear();
+        cycle_dirt_count = house.getTotalDirtCount();
     }
 
-    Step next_step;
-    if (statistics.num_steps_taken > max_simulator_steps)
+    const Position& position = house.getCurrentPosition();
+    std::size_t state_hash = std::hash<Position>()(position) ^ (battery.getBatteryState() << 1);
+
+    std::size_t cycle_length = 0;
+    auto sample = cycle_samples.find(state_hash);
+    if (cycle_samples.end() != sample && position == sample->second.position && battery == sample->second.battery)
     {
-        throw std::runtime_error("Simulator exceeded the maximal allowed steps!");
+        cycle_length = statistics.num_steps_taken - sample->second.num_steps_taken;
+    }
+
+    cycle_samples.insert_or_assign(state_hash, CycleSample{position, battery, statistics.num_steps_taken});
+
+    // Only the steps since the last snapshot taken (or restored) are at hand - a cycle is detected once they repeat it
+    const std::vector<Step>& step_history = statistics.step_history;
+    if (0 == cycle_length || step_history.size() < kCycleRepetitions * cycle_length)
+    {
+        return 0;
+    }
+
+    // The state repeated - it's a cycle if the steps leading to it repeated the same period as well
+    for (std::size_t i = step_history.size() - (kCycleRepetitions - 1) * cycle_length; i < step_history.size(); i++)
+    {
+        if (step_history[i] != step_history[i - cycle_length])
+        {
+            return 0;
+        }
+    }
+
+    return cycle_length;
+}
+
+void Simulator::repeatCycle(std::size_t cycle_length)
+{
+    std::vector<Step> cycle(statistics.step_history.end() - cycle_length, statistics.step_history.end());
+
+    std::size_t steps_left = max_simulator_steps - statistics.num_steps_taken;
+    std::size_t cycle_offset = steps_left % cycle_length;
+    std::size_t num_repeated_steps = steps_left - cycle_offset;
+
+    // Each full cycle ends at the current state - so only the steps of the last partial cycle are actually taken
+    statistics.step_history.reserve(max_simulator_steps);
+    for (std::size_t i = 0; i < num_repeated_steps; i++)
+    {
+        statistics.step_history.push_back(cycle[i % cycle_length]);
+    }
+
+    statistics.num_steps_taken += num_repeated_steps;
+
+    for (std::size_t i = 0; i < cycle_offset; i++)
+    {
+        move(cycle[i]);
     }
 
-    while (statistics.num_steps_taken <= max_simulator_steps)
+    // The step suggested once the maximal number of steps was reached
+    last_step = cycle[cycle_offset];
+}
+
+bool Simulator::takeStep(Step next_step)
+{
+    last_step = next_step;
+    if (statistics.num_steps_taken == max_simulator_steps && Step::Finish != last_step)
     {
-        next_step = algorithm->nextStep();
-        if (statistics.num_steps_taken == max_simulator_steps && Step::Finish != next_step)
+        finish();
+        return true;
+    }
+
+    move(last_step);
+    if (Status::Finished == statistics.mission_status || Status::Dead == statistics.mission_status)
+    {
+        finish();
+        return true;
+    }
+
+    if (0 != cycle_check_interval && 0 == statistics.num_steps_taken % cycle_check_interval && statistics.num_steps_taken < max_simulator_steps)
+    {
+        std::size_t cycle_length = detectCycle();
+        if (0 != cycle_length)
         {
-            break;
+            repeatCycle(cycle_length);
+            finish();
+            return true;
         }
+    }
+
+    return false;
+}
 
-        move(next_step);
-        if (Status::Finished == statistics.mission_status || Status::Dead == statistics.mission_status)
+std::size_t Simulator::takeMacroStep(const MacroStep& macro_step, std::size_t max_steps, bool& is_finished)
+{
+    std::size_t num_macro_steps = 0;
+    is_finished = false;
+
+    if (MacroStep::Kind::StayUntilBattery == macro_step.kind)
+    {
+        if (0 == macro_step.max_stays)
         {
-            break;
+            throw std::runtime_error("Algorithm returned an empty macro step!");
         }
+
+        std::size_t max_stays = std::min(macro_step.max_stays, max_steps);
+        while (!is_finished && num_macro_steps < max_stays)
+        {
+            // The first stay was decided on the current battery reading - later ones stop once it reaches the target
+            if (0 != num_macro_steps && battery.getBatteryState() >= macro_step.target_battery)
+            {
+                break;
+            }
+
+            num_macro_steps++;
+            is_finished = takeStep(Step::Stay);
+        }
+    }
+
+    else
+    {
+        if (macro_step.steps.empty())
+        {
+            throw std::runtime_error("Algorithm returned an empty macro step!");
+        }
+
+        std::size_t max_path_steps = std::min(macro_step.steps.size(), max_steps);
+        while (!is_finished && num_macro_steps < max_path_steps)
+        {
+            is_finished = takeStep(macro_step.steps[num_macro_steps]);
+            num_macro_steps++;
+        }
+    }
+
+    return num_macro_steps;
+}
+
+bool Simulator::checkRunnable() const
+{
+    if (SimulatorState::Finished == state)
+    {
+        return true;
+    }
+
+    if (SimulatorState::Ready != state)
+    {
+        throw std::logic_error("Called Simulator::run() before calling Simulator::setAlgorithm()");
+    }
+
+    if (statistics.num_steps_taken > max_simulator_steps)
+    {
+        throw std::runtime_error("Simulator exceeded the maximal allowed steps!");
+    }
+
+    return false;
+}
+
+bool Simulator::runFor(std::size_t step_budget)
+{
+    if (nullptr != macro_step_algorithm)
+    {
+        return dispatchAlgorithmFor(*macro_step_algorithm, step_budget);
     }
 
-    calculateScore(next_step);
-    return statistics.score;
+    return dispatchAlgorithmFor(*algorithm, step_budget);
 }
@@ -3,13 +3,22 @@
 
 #include <vector>
 #include <string>
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <sstream>
+#include <limits>
+#include <unordered_map>
+#include <stdexcept>
+#include <type_traits>
 
 #include "common/abstract_algorithm.h"
+#include "common/macro_step_algorithm.h"
+#include "common/planner_stats_algorithm.h"
 #include "common/enums.h"
 #include "common/position.h"
 
+#include "step_latency_histogram.h"
 #include "deserializer.h"
 #include "battery.h"
 #include "status.h"
@@ -30,6 +39,33 @@ struct SimulationStatistics
     std::size_t score;                          // Simulation's final score (computed on graceful finish only).
 };
 
+/**
+ * @brief The StepHistorySegment struct represents an immutable run of a step history, shared by snapshots and their forks.
+ */
+struct StepHistorySegment
+{
+    std::shared_ptr<const StepHistorySegment> prefix;   // The segment of the steps taken before this one's (null if none).
+    std::vector<Step> steps;                            // The segment's steps.
+};
+
+/**
+ * @brief The SimulatorSnapshot struct represents the state of a running simulation, to be restored by other simulators.
+ *
+ * Snapshots are taken with the robot at the docking station and a full battery only (e.g. after a charge cycle):
+ * an algorithm taking over a restored snapshot sees it as the start of a new simulation, docked and fully charged.
+ *
+ * The snapshot's house shares its maps with the simulator it was taken from (copy-on-write, see House), and its
+ * step history is shared as well - so forking many simulations from a snapshot costs close to nothing.
+ */
+struct SimulatorSnapshot
+{
+    House house;                                // The house state (robot position and dirt levels).
+    Battery battery;                            // The battery state.
+    SimulationStatistics statistics;            // The statistics counters so far (with no step history, see step_history).
+    std::shared_ptr<const StepHistorySegment> step_history; // The steps taken so far (null if none).
+    std::size_t max_simulator_steps;            // The simulation's maximal number of steps.
+};
+
 /**
  * @brief The Simulator class represents a vacuum cleaning robot.
  *
@@ -43,15 +79,37 @@ class Simulator
     enum class SimulatorState
     {
         NoAlgorithm,
-        Ready
+        Ready,
+        Finished
     };
 
-    SimulationStatistics statistics;                    // Simulation Statistics (some fields are computed on demand)
+    SimulationStatistics statistics;                    // Simulation Statistics (some fields are computed on demand, see getSimulationStatistics())
+    std::shared_ptr<const StepHistorySegment> step_history_prefix;  // The steps taken before the ones in statistics' step history (e.g. a restored snapshot's).
     SimulatorState state = SimulatorState::NoAlgorithm; // Simulator's initialization current state.
     std::size_t max_simulator_steps;                    // Maximum number of steps the simulator can perform.
     House house;                                        // Simulator's house representation.
     Battery battery;                                    // Simulator's battery (for charging / discharging and getting battery level).
     AbstractAlgorithm* algorithm = nullptr;             // Simulator's algorithm to suggest its next steps.
+    MacroStepAlgorithm* macro_step_algorithm = nullptr; // The algorithm's macro step interface (if it implements one).
+    const PlannerStatsAlgorithm* planner_stats_algorithm = nullptr; // The algorithm's planner stats interface (if it implements one).
+    Step last_step = Step::Stay;                        // The last step suggested by the algorithm (kept between run slices).
+
+    /* Cycle detection */
+    struct CycleSample
+    {
+        Position position;                              // The robot's position when sampled.
+        Battery battery;                                // The battery state when sampled.
+        std::size_t num_steps_taken;                    // The number of steps taken when sampled.
+    };
+
+    static const std::size_t kCycleRepetitions = 3;     // The number of identical step periods (ending at a repeated state) to detect a cycle.
+
+    std::size_t cycle_check_interval = 0;               // The number of steps between state samples (0 if cycle detection is disabled).
+    std::size_t cycle_dirt_count = 0;                   // The dirt count when the current state samples were taken.
+    std::unordered_map<std::size_t, CycleSample> cycle_samples; // The state samples taken since dirt was last cleaned (by state hash).
+
+    /* Step timing */
+    std::unique_ptr<StepLatencyHistogram> step_latencies;       // The latencies of the algorithm's step calls (null if step timing is disabled).
 
     /* Scoring */
     static const std::size_t kDeadPenalty = 2000;        // The penalty for a dead robot.
@@ -73,34 +131,142 @@ class Simulator
     void move(Step next_step);
 
     /**
-     * @brief Determines whether or not DEAD scoring condition applies.
-     *
+     * @brief Calculates the score of the cleaning mission (stores result into SimulationStatistics).
+     * 
      * @param next_step The next step to be taken.
+     * 
+     * A link to a further explanation about the scoring method:
+     * https://moodle.tau.ac.il/mod/forum/discuss.php?d=109220
+    */
+    void calculateScore(Step last_step);
+
+    /**
+     * @brief Finishes the simulation - computes its score, and prevents it from being resumed.
      */
-    bool isDeadScoring(Step last_step)
+    void finish();
+
+    /**
+     * @brief Samples the robot's state, and checks whether the simulation is caught in a cycle (see enableCycleDetection()).
+     *
+     * @returns The length of the detected cycle (in steps), or 0 if no cycle was detected.
+     */
+    std::size_t detectCycle();
+
+    /**
+     * @brief Takes the rest of the simulation's steps by repeating its last cycle - updating the statistics and the
+     * robot's state as if the algorithm kept suggesting the cycle's steps until the maximal number of steps was reached.
+     *
+     * @param cycle_length The length of the cycle (in steps).
+     */
+    void repeatCycle(std::size_t cycle_length);
+
+    /**
+     * @brief Takes a single step suggested by the algorithm.
+     *
+     * @param next_step The step to be taken.
+     *
+     * @returns Whether or not the simulation is finished.
+     */
+    bool takeStep(Step next_step);
+
+    /**
+     * @brief Takes a macro step suggested by the algorithm (or a prefix of it).
+     *
+     * @param macro_step The macro step to be taken.
+     * @param max_steps The maximal number of steps to be taken.
+     * @param is_finished Set to whether or not the simulation is finished.
+     *
+     * @returns The number of steps taken.
+     *
+     * @throws std::runtime_error If the algorithm returned an empty macro step.
+     */
+    std::size_t takeMacroStep(const MacroStep& macro_step, std::size_t max_steps, bool& is_finished);
+
+    /**
+     * @brief Checks whether the simulation can be run (or resumed).
+     *
+     * @returns Whether or not the simulation is already finished.
+     *
+     * @throws std::logic_error If the simulator is not properly initialized yet.
+     */
+    bool checkRunnable() const;
+
+    /**
+     * @brief Calls the algorithm (for its next step or macro step), timing the call if step timing is enabled.
+     */
+    template <bool kIsTimingSteps, typename AlgorithmCall>
+    decltype(auto) callAlgorithm(AlgorithmCall&& algorithm_call)
     {
-        return (Step::Finish != last_step && battery.isBatteryExhausted() && !house.isAtDockingStation());
+        if constexpr (kIsTimingSteps)
+        {
+            std::chrono::steady_clock::time_point call_start_time = std::chrono::steady_clock::now();
+            decltype(auto) result = algorithm_call();
+            step_latencies->record(std::chrono::steady_clock::now() - call_start_time);
+            return result;
+        }
+
+        else
+        {
+            return algorithm_call();
+        }
     }
 
     /**
-     * @brief Determines whether or not LYING scoring condition applies.
+     * @brief Runs (or resumes) the simulation with a given view of its algorithm.
      *
-     * @param next_step The next step to be taken.
+     * The algorithm's calls are dispatched by its static type - so a `final` algorithm class is called directly.
+     * A static type which implements MacroStepAlgorithm is run by macro steps.
+     * The step loop is instantiated apart for step timing, so a simulation which isn't timed doesn't pay for it.
      */
-    bool isLyingScoring(Step last_step)
+    template <bool kIsTimingSteps, typename StepAlgorithm>
+    bool runAlgorithmFor(StepAlgorithm& step_algorithm, std::size_t step_budget)
     {
-        return (Step::Finish == last_step && !house.isAtDockingStation());
+        if (checkRunnable())
+        {
+            return true;
+        }
+
+        std::size_t requested_steps = 0;
+        while (requested_steps < step_budget)
+        {
+            bool is_finished = false;
+            if constexpr (std::is_base_of_v<MacroStepAlgorithm, StepAlgorithm>)
+            {
+                MacroStep macro_step = callAlgorithm<kIsTimingSteps>([&step_algorithm]() { return step_algorithm.nextMacroStep(); });
+                std::size_t num_macro_steps = takeMacroStep(macro_step, step_budget - requested_steps, is_finished);
+                step_algorithm.onMacroStepDone(num_macro_steps);
+                requested_steps += num_macro_steps;
+            }
+
+            else
+            {
+                requested_steps++;
+                is_finished = takeStep(callAlgorithm<kIsTimingSteps>([&step_algorithm]() { return step_algorithm.nextStep(); }));
+            }
+
+            if (is_finished)
+            {
+                return true;
+            }
+        }
+
+        // Step budget exhausted - the simulation is resumed by the next call
+        return false;
     }
 
     /**
-     * @brief Calculates the score of the cleaning mission (stores result into SimulationStatistics).
-     * 
-     * @param next_step The next step to be taken.
-     * 
-     * A link to a further explanation about the scoring method:
-     * https://moodle.tau.ac.il/mod/forum/discuss.php?d=109220
-    */
-    void calculateScore(Step last_step);
+     * @brief Runs (or resumes) the simulation with a given view of its algorithm (see runAlgorithmFor()), timed if step timing is enabled.
+     */
+    template <typename StepAlgorithm>
+    bool dispatchAlgorithmFor(StepAlgorithm& step_algorithm, std::size_t step_budget)
+    {
+        if (nullptr != step_latencies)
+        {
+            return runAlgorithmFor<true>(step_algorithm, step_budget);
+        }
+
+        return runAlgorithmFor<false>(step_algorithm, step_budget);
+    }
 
 public:
     Simulator(const HouseFile& house_file);
@@ -121,27 +287,150 @@ public:
     /**
      * @brief Computes the simulation Timeout score (in case needed - on timeout).
      */
-    std::size_t getTimeoutScore() const { return (2 * max_simulator_steps + house.getInitialDirtCount() * kDirtFactor + kTimeoutPenalty); }
+    std::size_t getTimeoutScore() const { return computeTimeoutScore(max_simulator_steps, house.getInitialDirtCount()); }
 
     /**
-     * @brief Returns simulation statistics report.
+     * @brief Computes the Timeout score of a simulation with given parameters.
+     *
+     * @param max_steps The simulation's maximal number of steps.
+     * @param initial_dirt_count The house's initial dirt count.
      */
-    const SimulationStatistics& getSimulationStatistics()
+    static std::size_t computeTimeoutScore(std::size_t max_steps, std::size_t initial_dirt_count)
     {
-        statistics.dirt_left = house.getTotalDirtCount();
-        statistics.is_at_docking_station = house.isAtDockingStation();
-        return statistics;
+        return 2 * max_steps + initial_dirt_count * kDirtFactor + kTimeoutPenalty;
     }
 
+    /**
+     * @brief Computes the score of a finished simulation, from its final state.
+     *
+     * A robot which wasn't finished by a Finish step, and is out of battery away from the docking station is DEAD;
+     * a robot which was finished away from the docking station is LYING - both are scored as if all steps were taken.
+     *
+     * @param last_step The last step suggested by the algorithm (the Finish step, or the step beyond the maximal number of steps).
+     * @param num_steps_taken The number of steps taken.
+     * @param max_steps The simulation's maximal number of steps.
+     * @param dirt_left The dirt amount left in the house.
+     * @param is_at_docking_station Whether or not the robot is at the docking station.
+     * @param is_battery_exhausted Whether or not the robot's battery is exhausted.
+     */
+    static std::size_t computeScore(Step last_step,
+                                    std::size_t num_steps_taken,
+                                    std::size_t max_steps,
+                                    std::size_t dirt_left,
+                                    bool is_at_docking_station,
+                                    bool is_battery_exhausted);
+
+    /**
+     * @brief Returns simulation statistics report.
+     *
+     * The step history of a simulation restored from a snapshot is completed by the snapshot's steps (once).
+     */
+    const SimulationStatistics& getSimulationStatistics();
+
+    /**
+     * @brief Takes a snapshot of the simulation's current state.
+     *
+     * The steps taken so far are moved into a segment shared with the snapshot - so a snapshot costs about as much
+     * as the steps taken since the previous one (or since the restored snapshot).
+     *
+     * @throws std::logic_error If the simulation is already finished, or the robot isn't docked with a full battery.
+     */
+    SimulatorSnapshot takeSnapshot();
+
+    /**
+     * @brief Returns whether or not a snapshot can be taken - the robot is at the docking station, with a full battery.
+     */
+    bool isSnapshotReady() const { return house.isAtDockingStation() && battery.isFull(); }
+
+    /**
+     * @brief Restores the simulation's state from a snapshot (forks the snapshot's simulation).
+     *
+     * The algorithm set afterwards takes over from the snapshot's state, as if it was starting a new simulation
+     * at the snapshot's position and battery level, with the remaining number of steps.
+     * The snapshot isn't affected by the restored simulation (and can be restored by any number of simulators).
+     *
+     * @param snapshot The snapshot to be restored.
+     *
+     * @throws std::logic_error If this function was not called before setAlgorithm(), or the snapshot's robot isn't docked with a full battery.
+     */
+    void restoreSnapshot(const SimulatorSnapshot& snapshot);
+
     /**
      * @brief Sets the algorithm to be used by the simulator.
      *
+     * An algorithm which also implements MacroStepAlgorithm is run by macro steps.
+     * The algorithm's maximal number of steps is the number of steps left (less than MaxSteps on a restored snapshot).
+     *
      * @param algorithm The algorithm to be used.
      * 
      * @throws std::logic_error If this function was not called at the beginning of the initialization.
      */
     void setAlgorithm(AbstractAlgorithm& algorithm);
 
+    /**
+     * @brief Enables cycle detection - finishing a simulation early once its robot loops with no dirt being cleaned.
+     *
+     * Every `check_interval` steps, the robot's position and battery state are sampled. Once a sampled state repeats
+     * with no dirt cleaned in between, and the steps leading to it repeated the same period a few times in a row,
+     * the algorithm is considered livelocked: the rest of the steps (up to MaxSteps) are taken by repeating the period,
+     * with no further algorithm calls - resulting in the same statistics and score as running it to the end.
+     *
+     * The detection assumes the algorithm's steps depend on what it senses only - an algorithm which breaks out of
+     * a loop on its own (e.g. by counting its steps) may be scored differently than it would be on a full run.
+     *
+     * @param check_interval The number of steps between state samples (0 disables cycle detection).
+     */
+    void enableCycleDetection(std::size_t check_interval) { cycle_check_interval = check_interval; }
+
+    /**
+     * @brief Enables (or disables) step timing - recording the latency of each of the algorithm's step calls.
+     *
+     * A macro step algorithm's calls are timed by macro steps (each nextMacroStep() call is a single latency).
+     * Enabling step timing discards the latencies recorded so far.
+     *
+     * @param is_enabled Whether or not the algorithm's step calls should be timed.
+     */
+    void enableStepTiming(bool is_enabled) { step_latencies = is_enabled ? std::make_unique<StepLatencyHistogram>() : nullptr; }
+
+    /**
+     * @brief Returns the latencies of the algorithm's step calls (null if step timing is disabled).
+     */
+    const StepLatencyHistogram* getStepLatencies() const { return step_latencies.get(); }
+
+    /**
+     * @brief Returns the algorithm's planner stats (if it implements the PlannerStatsAlgorithm interface).
+     *
+     * Must not be called while the algorithm is running (e.g. by another thread, on a timeout).
+     */
+    std::optional<PlannerStats> getPlannerStats() const
+    {
+        if (nullptr == planner_stats_algorithm)
+        {
+            return std::nullopt;
+        }
+
+        return planner_stats_algorithm->getPlannerStats();
+    }
+
+    /**
+     * @brief Runs (or resumes) the cleaning operation for a limited number of algorithm steps.
+     *
+     * The simulation can be resumed by calling this method again, until it's finished - in which case its score
+     * is available in the simulation statistics (see run() for the finish conditions).
+     *
+     * @param step_budget The maximal number of steps to be taken during this call (macro steps are counted by their steps).
+     *
+     * @returns Whether or not the simulation is finished.
+     *
+     * @throws std::logic_error If the simulator is not properly initialized yet.
+     */
+    bool runFor(std::size_t step_budget);
+
+    /**
+     * @brief Returns whether or not the simulation is finished (its score is computed).
+     */
+    bool isFinished() const { return SimulatorState::Finished == state; }
+
     /**
      * @brief Runs the cleaning operation.
      *
@@ -154,7 +443,34 @@ public:
      * 
      * @throws std::logic_error If the simulator is not properly initialized yet.
      */
-    std::size_t run();
+    std::size_t run()
+    {
+        runFor(std::numeric_limits<std::size_t>::max());
+        return statistics.score;
+    }
+
+    /**
+     * @brief Runs the cleaning operation, calling the algorithm by its concrete type (see run()).
+     *
+     * Calls to a `final` algorithm class are dispatched statically (and may be inlined), rather than through AbstractAlgorithm.
+     *
+     * @param concrete_algorithm The algorithm set by setAlgorithm().
+     *
+     * @returns The simulation result of the cleaning mission.
+     *
+     * @throws std::logic_error If the simulator is not properly initialized yet, or was set with a different algorithm.
+     */
+    template <typename ConcreteAlgorithm>
+    std::size_t run(ConcreteAlgorithm& concrete_algorithm)
+    {
+        if (static_cast<AbstractAlgorithm*>(&concrete_algorithm) != algorithm)
+        {
+            throw std::logic_error("Simulator::run() was called with an algorithm other than the one set by Simulator::setAlgorithm()");
+        }
+
+        dispatchAlgorithmFor(concrete_algorithm, std::numeric_limits<std::size_t>::max());
+        return statistics.score;
+    }
 };
 
 #endif /* ROBOT_SIMULATOR_H_ */
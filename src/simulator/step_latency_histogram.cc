@@ -0,0 +1,84 @@
+#include "step_latency_histogram.h"
+
+#include <bit>
+#include <cmath>
+#include <algorithm>
+
+std::size_t StepLatencyHistogram::getBucketIndex(std::uint64_t latency)
+{
+    if (latency < kSubBuckets)
+    {
+        return static_cast<std::size_t>(latency);
+    }
+
+    // The latency's power of two picks its bucket group, and its next kSubBucketBits bits pick the bucket in the group
+    std::size_t shift = static_cast<std::size_t>(std::bit_width(latency)) - 1 - kSubBucketBits;
+    std::size_t sub_bucket = static_cast<std::size_t>(latency >> shift) - kSubBuckets;
+
+    return (shift + 1) * kSubBuckets + sub_bucket;
+}
+
+std::uint64_t StepLatencyHistogram::getBucketUpperBound(std::size_t bucket_index)
+{
+    if (bucket_index < kSubBuckets)
+    {
+        return static_cast<std::uint64_t>(bucket_index);
+    }
+
+    std::size_t shift = bucket_index / kSubBuckets - 1;
+    std::uint64_t lower_bound = static_cast<std::uint64_t>(kSubBuckets + bucket_index % kSubBuckets) << shift;
+
+    return lower_bound + ((std::uint64_t(1) << shift) - 1);
+}
+
+void StepLatencyHistogram::record(std::chrono::nanoseconds latency)
+{
+    std::uint64_t latency_count = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(0, latency.count()));
+
+    increment(bucket_counts[getBucketIndex(latency_count)]);
+    increment(num_samples);
+
+    if (latency_count > max_latency.load(std::memory_order_relaxed))
+    {
+        max_latency.store(latency_count, std::memory_order_relaxed);
+    }
+}
+
+std::chrono::nanoseconds StepLatencyHistogram::getPercentile(double percentile) const
+{
+    std::size_t count = getCount();
+    if (0 == count)
+    {
+        return std::chrono::nanoseconds::zero();
+    }
+
+    // The rank (1-based) of the percentile's latency among the recorded latencies
+    double exact_rank = std::ceil(std::clamp(percentile, 0.0, 1.0) * static_cast<double>(count));
+    std::size_t rank = std::max<std::size_t>(1, static_cast<std::size_t>(exact_rank));
+
+    std::uint64_t max_latency_count = max_latency.load(std::memory_order_relaxed);
+    std::size_t cumulative_count = 0;
+
+    for (std::size_t bucket_index = 0; bucket_index < kNumBuckets; bucket_index++)
+    {
+        cumulative_count += bucket_counts[bucket_index].load(std::memory_order_relaxed);
+        if (cumulative_count >= rank)
+        {
+            return std::chrono::nanoseconds(std::min(getBucketUpperBound(bucket_index), max_latency_count));
+        }
+    }
+
+    // Read while being recorded - the buckets lag behind the count
+    return std::chrono::nanoseconds(max_latency_count);
+}
+
+StepLatencySummary StepLatencyHistogram::getSummary() const
+{
+    return {
+        .num_calls = getCount(),
+        .p50 = getPercentile(0.5),
+        .p99 = getPercentile(0.99),
+        .p999 = getPercentile(0.999),
+        .max = getMax()
+    };
+}
@@ -0,0 +1,91 @@
+#ifndef STEP_LATENCY_HISTOGRAM_H_
+#define STEP_LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The StepLatencySummary struct represents the latency percentiles of an algorithm's step calls.
+ */
+struct StepLatencySummary
+{
+    std::size_t num_calls = 0;                      // The number of timed step calls.
+    std::chrono::nanoseconds p50{0};                // Median step call latency.
+    std::chrono::nanoseconds p99{0};                // 99th percentile step call latency.
+    std::chrono::nanoseconds p999{0};               // 99.9th percentile step call latency.
+    std::chrono::nanoseconds max{0};                // Slowest step call latency (exact).
+};
+
+/**
+ * @brief The StepLatencyHistogram class records latencies into a log-linear histogram.
+ *
+ * Latencies are bucketed by their power of two, each power of two split into kSubBuckets linear buckets - so recording
+ * a latency is a few bit operations, the histogram takes a fixed amount of memory, and a percentile read from it is
+ * above the true percentile by at most 1 / kSubBuckets of it (latencies below kSubBuckets nanoseconds are exact).
+ *
+ * Latencies are recorded by a single thread, but may be read by any thread while being recorded (e.g. on a timeout) -
+ * the counters are relaxed atomics, updated by plain loads and stores (no read-modify-write instructions).
+ */
+class StepLatencyHistogram
+{
+    static constexpr const std::size_t kSubBucketBits = 4;
+    static constexpr const std::size_t kSubBuckets = 1 << kSubBucketBits;                  // Linear buckets per power of two.
+    static constexpr const std::size_t kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets; // Covers any 64 bit latency.
+
+    std::array<std::atomic<std::uint64_t>, kNumBuckets> bucket_counts{};                    // The number of latencies in each bucket.
+    std::atomic<std::size_t> num_samples = 0;                                               // The number of recorded latencies.
+    std::atomic<std::uint64_t> max_latency = 0;                                             // The maximal recorded latency (in nanoseconds).
+
+    /**
+     * @brief Increments a counter (by its single writer).
+     */
+    template <typename T>
+    static void increment(std::atomic<T>& counter) { counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Computes the bucket of a latency (in nanoseconds).
+     */
+    static std::size_t getBucketIndex(std::uint64_t latency);
+
+    /**
+     * @brief Computes the highest latency (in nanoseconds) of a bucket.
+     */
+    static std::uint64_t getBucketUpperBound(std::size_t bucket_index);
+
+public:
+    /**
+     * @brief Records a single latency (by the histogram's single writer thread).
+     *
+     * @param latency The latency to be recorded (negative latencies are recorded as 0).
+     */
+    void record(std::chrono::nanoseconds latency);
+
+    /**
+     * @brief Returns the number of recorded latencies.
+     */
+    std::size_t getCount() const { return num_samples.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the maximal recorded latency (0 if none was recorded).
+     */
+    std::chrono::nanoseconds getMax() const { return std::chrono::nanoseconds(max_latency.load(std::memory_order_relaxed)); }
+
+    /**
+     * @brief Computes a percentile of the recorded latencies.
+     *
+     * @param percentile The percentile to be computed (between 0 and 1).
+     *
+     * @return The highest latency of the percentile's bucket (capped by the maximal latency), or 0 if none was recorded.
+     */
+    std::chrono::nanoseconds getPercentile(double percentile) const;
+
+    /**
+     * @brief Summarizes the recorded latencies (their p50, p99, p999 and maximum).
+     */
+    StepLatencySummary getSummary() const;
+};
+
+#endif /* STEP_LATENCY_HISTOGRAM_H_ */
@@ -0,0 +1,271 @@
+#include "slice_scheduler.h"
+
+#include "output_handler.h"
+#include "memory_tracker.h"
+#include "trace_recorder.h"
+
+#include <time.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace
+{
+    std::chrono::nanoseconds readThreadCpuTime()
+    {
+        timespec cpu_time;
+        if (0 != clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time))
+        {
+            return std::chrono::nanoseconds::zero();
+        }
+
+        return std::chrono::seconds(cpu_time.tv_sec) + std::chrono::nanoseconds(cpu_time.tv_nsec);
+    }
+}
+
+SliceScheduler::SlicedTask::SlicedTask(const Job& job, std::size_t job_index)
+    : job(job),
+      job_index(job_index),
+      algorithm(job.algorithm_factory()),
+      simulator(*job.house_file),
+      timeout_score(simulator.getTimeoutScore())
+{
+    simulator.enableCycleDetection(job.cycle_check_interval);
+    simulator.enableStepTiming(job.is_step_timed);
+    simulator.setAlgorithm(*algorithm);
+    performance.time_budget = std::chrono::milliseconds(simulator.getMaxSteps());
+    recordProgress();
+}
+
+void SliceScheduler::SlicedTask::recordProgress()
+{
+    const SimulationStatistics& statistics = simulator.getSimulationStatistics();
+    progress.num_steps_taken = statistics.num_steps_taken;
+    progress.dirt_left = statistics.dirt_left;
+    progress.is_at_docking_station = statistics.is_at_docking_station;
+    progress.mission_status = statistics.mission_status;
+
+    performance.num_steps = statistics.num_steps_taken;
+    if (nullptr != simulator.getStepLatencies())
+    {
+        performance.step_latencies = simulator.getStepLatencies()->getSummary();
+    }
+}
+
+SliceScheduler::SliceScheduler(const std::vector<Job>& jobs,
+                               std::size_t num_threads,
+                               std::size_t step_slice,
+                               const TimeoutPolicy& timeout_policy,
+                               bool summary_only)
+    : jobs(jobs),
+      num_threads(std::max<std::size_t>(1, num_threads)),
+      step_slice(std::max<std::size_t>(1, step_slice)),
+      timeout_policy(timeout_policy),
+      summary_only(summary_only),
+      results(jobs.size())
+{}
+
+void SliceScheduler::finishTask(SlicedTask& task,
+                                std::size_t score,
+                                const std::string& algorithm_error,
+                                bool is_timeout,
+                                const SimulationStatistics& statistics)
+{
+    task.performance.wall_time = std::chrono::steady_clock::now() - task.first_slice_time;
+    task.performance.is_timeout = is_timeout;
+
+    results[task.job_index] = {
+        .score = score,
+        .algorithm_error = algorithm_error,
+        .performance = task.performance
+    };
+
+    if (!summary_only)
+    {
+        OutputHandler::exportStatistics(task.job.algorithm_name, task.job.house_file->name, statistics, score);
+    }
+
+    num_finished++;
+    done_condition.notify_all();
+
+    if (tasks.size() == num_finished)
+    {
+        // Wake up idle workers so they can exit
+        ready_condition.notify_all();
+    }
+}
+
+void SliceScheduler::workerMain(std::shared_ptr<WorkerState> worker_state)
+{
+    TraceRecorder::setThreadName("slice worker");
+    std::unique_lock lock(scheduler_mutex);
+
+    while (true)
+    {
+        ready_condition.wait(lock, [this]() { return !ready_tasks.empty() || tasks.size() == num_finished; });
+        if (ready_tasks.empty())
+        {
+            return;
+        }
+
+        // Owned by this thread as well - so an abandoned slice's task outlives the scheduler (if it has to)
+        std::shared_ptr<SlicedTask> task_pointer = ready_tasks.front();
+        SlicedTask& task = *task_pointer;
+        ready_tasks.pop_front();
+
+        worker_state->task = task_pointer;
+        worker_state->slice_start_time = std::chrono::steady_clock::now();
+        worker_state->is_slice_ended.store(false);
+
+        if (!task.is_started)
+        {
+            task.is_started = true;
+            task.first_slice_time = worker_state->slice_start_time;
+        }
+
+        lock.unlock();
+
+        MemoryTracker::resetThreadUsage();
+        std::chrono::nanoseconds start_cpu_time = readThreadCpuTime();
+
+        std::string algorithm_error;
+        bool is_finished = true;
+
+        try
+        {
+            is_finished = task.simulator.runFor(step_slice);
+        }
+
+        catch (const std::exception& exception)
+        {
+            algorithm_error = exception.what();
+        }
+
+        std::chrono::nanoseconds slice_cpu_time = readThreadCpuTime() - start_cpu_time;
+        std::chrono::nanoseconds slice_wall_time = std::chrono::steady_clock::now() - worker_state->slice_start_time;
+        std::size_t slice_peak_memory = static_cast<std::size_t>(MemoryTracker::getThreadUsage().peak_bytes.load());
+
+        bool expected_value = false;
+        if (!worker_state->is_slice_ended.compare_exchange_strong(expected_value, true))
+        {
+            // The watchdog timed out the task (and replaced this thread) - nothing but the task is ours to touch anymore
+            // (the scheduler and the task's job may already be gone).
+            return;
+        }
+
+        if (TraceRecorder::isEnabled())
+        {
+            TraceRecorder::recordSpan("task", task.job.house_file->name + "-" + task.job.algorithm_name,
+                                      worker_state->slice_start_time, worker_state->slice_start_time + slice_wall_time,
+                                      TraceRecorder::formatArgument("algorithm", task.job.algorithm_name) + "," + TraceRecorder::formatArgument("house", task.job.house_file->name));
+        }
+
+        if (!algorithm_error.empty())
+        {
+            algorithm_error = formatJobError(task.job, algorithm_error);
+        }
+
+        lock.lock();
+
+        worker_state->task = nullptr;
+        task.recordProgress();
+
+        task.charged_time += timeout_policy.is_cpu_time ? slice_cpu_time : slice_wall_time;
+        task.performance.cpu_time += slice_cpu_time;
+        task.performance.peak_memory_bytes = std::max(task.performance.peak_memory_bytes, slice_peak_memory);
+
+        bool is_timeout = !is_finished && algorithm_error.empty() && task.charged_time >= getTimeBudget(task);
+
+        if (is_finished || is_timeout)
+        {
+            // Collected here (between slices) only - the watchdog can't read them while this thread may still run the algorithm
+            task.performance.planner_stats = task.simulator.getPlannerStats();
+
+            const SimulationStatistics& statistics = task.simulator.getSimulationStatistics();
+            std::size_t score = task.simulator.isFinished() && algorithm_error.empty() ? statistics.score : task.timeout_score;
+            finishTask(task, score, algorithm_error, is_timeout, statistics);
+        }
+
+        else
+        {
+            ready_tasks.push_back(std::move(task_pointer));
+            ready_condition.notify_one();
+        }
+    }
+}
+
+void SliceScheduler::spawnWorker(std::size_t worker_index)
+{
+    worker_states[worker_index] = std::make_shared<WorkerState>();
+    worker_threads[worker_index] = std::jthread(&SliceScheduler::workerMain, this, worker_states[worker_index]);
+}
+
+void SliceScheduler::abandonStuckSlices()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    for (std::size_t worker_index = 0; worker_index < worker_states.size(); worker_index++)
+    {
+        WorkerState& worker_state = *worker_states[worker_index];
+        if (nullptr == worker_state.task)
+        {
+            continue;
+        }
+
+        SlicedTask& task = *worker_state.task;
+
+        // The slice's CPU time can't be read from here - so under a CPU time policy, only the wall-clock ceiling applies.
+        std::chrono::nanoseconds remaining_budget = getTimeBudget(task) - task.charged_time;
+        if (timeout_policy.is_cpu_time)
+        {
+            remaining_budget *= timeout_policy.wall_ceiling_factor;
+        }
+
+        if (now - worker_state.slice_start_time < remaining_budget)
+        {
+            continue;
+        }
+
+        bool expected_value = false;
+        if (worker_state.is_slice_ended.compare_exchange_strong(expected_value, true))
+        {
+            // The abandoned thread may still be running the simulator - so only the progress of its last completed slice is exported
+            finishTask(task, task.timeout_score, "", true, task.progress);
+
+            worker_threads[worker_index].detach();
+            spawnWorker(worker_index);
+        }
+    }
+}
+
+void SliceScheduler::run()
+{
+    std::unique_lock lock(scheduler_mutex);
+
+    std::size_t job_index = 0;
+    for (const auto& job : jobs)
+    {
+        tasks.push_back(std::make_shared<SlicedTask>(job, job_index++));
+        ready_tasks.push_back(tasks.back());
+    }
+
+    worker_states.resize(num_threads);
+    worker_threads.resize(num_threads);
+    for (std::size_t worker_index = 0; worker_index < num_threads; worker_index++)
+    {
+        spawnWorker(worker_index);
+    }
+
+    while (tasks.size() != num_finished)
+    {
+        done_condition.wait_for(lock, kWatchdogInterval);
+        abandonStuckSlices();
+    }
+
+    lock.unlock();
+
+    for (auto& worker_thread : worker_threads)
+    {
+        worker_thread.join();
+    }
+}
@@ -0,0 +1,151 @@
+#ifndef SLICE_SCHEDULER_H_
+#define SLICE_SCHEDULER_H_
+
+#include "task.h"
+#include "job.h"
+
+#include "simulator/simulator.h"
+
+#include <condition_variable>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+
+/**
+ * @brief The SliceScheduler class multiplexes many simulations over a fixed number of worker threads.
+ *
+ * Each simulation is run in slices of a fixed number of steps (see Simulator::runFor()). A worker thread takes the
+ * first ready simulation, runs a single slice of it, and puts it back at the end of the ready queue - so all
+ * simulations progress fairly, and short simulations don't wait behind long ones.
+ *
+ * A simulation's time budget (MaxSteps milliseconds) is charged with the time of its slices only (wall-clock or CPU
+ * time, by the timeout policy) - time spent waiting in the ready queue isn't charged.
+ * A slice can't be preempted in the middle of an algorithm step: if a single slice outruns the simulation's remaining
+ * budget (its wall-clock ceiling, under a CPU time policy), the simulation is timed out and its worker thread is
+ * abandoned (detached, like a stuck Task thread) and replaced by a new one. The abandoned thread keeps its simulation
+ * alive (by shared ownership) - and the timed out result is made of the simulation's progress at its last completed
+ * slice, since its simulator can't be read while the abandoned thread may still be running it.
+ */
+class SliceScheduler
+{
+    static constexpr const auto kWatchdogInterval = std::chrono::milliseconds(5);  // Maximal wait between stuck slices checks.
+
+    /**
+     * @brief A simulation being scheduled.
+     */
+    struct SlicedTask
+    {
+        const Job& job;
+        std::size_t job_index;
+        std::unique_ptr<AbstractAlgorithm> algorithm;
+        Simulator simulator;
+        const std::size_t timeout_score;                        // The simulation's score if it times out.
+        std::chrono::nanoseconds charged_time{0};               // Time budget consumed by the simulation's slices.
+        std::chrono::steady_clock::time_point first_slice_time; // The time the simulation's first slice started at.
+        bool is_started = false;
+        TaskPerformance performance;
+        SimulationStatistics progress;                          // The statistics counters at the last completed slice (with no step history).
+
+        SlicedTask(const Job& job, std::size_t job_index);
+
+        /**
+         * @brief Records the simulation's progress (its statistics counters and step latencies), between slices.
+         */
+        void recordProgress();
+    };
+
+    /**
+     * @brief A worker thread's current slice (shared between the worker thread and the watchdog).
+     */
+    struct WorkerState
+    {
+        std::shared_ptr<SlicedTask> task;                       // The task of the running slice (null when idle).
+        std::chrono::steady_clock::time_point slice_start_time;
+        std::atomic<bool> is_slice_ended{true};                 // Claimed (once per slice) by either the worker or the watchdog.
+    };
+
+    const std::vector<Job>& jobs;
+    const std::size_t num_threads;
+    const std::size_t step_slice;
+    const TimeoutPolicy timeout_policy;
+    const bool summary_only;
+
+    std::mutex scheduler_mutex;
+    std::condition_variable ready_condition;                    // Signalled on each ready task (or when all tasks are done).
+    std::condition_variable done_condition;                     // Signalled on each finished task.
+
+    std::vector<std::shared_ptr<SlicedTask>> tasks;             // Shared with the worker threads (an abandoned thread outlives the scheduler).
+    std::deque<std::shared_ptr<SlicedTask>> ready_tasks;
+    std::vector<std::shared_ptr<WorkerState>> worker_states;  // Shared with the worker threads (an abandoned thread outlives its slot).
+    std::vector<std::jthread> worker_threads;
+    std::vector<JobResult> results;
+    std::size_t num_finished = 0;
+
+    /**
+     * @brief Returns the time budget of a given task.
+     */
+    static std::chrono::nanoseconds getTimeBudget(const SlicedTask& task)
+    {
+        return task.performance.time_budget;
+    }
+
+    /**
+     * @brief The main loop of a worker thread - runs slices until all tasks are finished (or it's abandoned).
+     */
+    void workerMain(std::shared_ptr<WorkerState> worker_state);
+
+    /**
+     * @brief Spawns a new worker thread into a given worker index.
+     */
+    void spawnWorker(std::size_t worker_index);
+
+    /**
+     * @brief Stores the result of a finished task (must be called with the scheduler mutex held).
+     *
+     * @param task The finished task (its performance and progress must be up to date).
+     * @param score The task's score.
+     * @param algorithm_error The task's algorithm error (empty if none).
+     * @param is_timeout Whether or not the task timed out.
+     * @param statistics The task's statistics to be exported.
+     */
+    void finishTask(SlicedTask& task, std::size_t score, const std::string& algorithm_error, bool is_timeout, const SimulationStatistics& statistics);
+
+    /**
+     * @brief Times out tasks whose running slice outran their remaining budget (must be called with the scheduler mutex held).
+     */
+    void abandonStuckSlices();
+
+public:
+    /**
+     * @param jobs The jobs to be simulated (must outlive the scheduler).
+     * @param num_threads The number of worker threads.
+     * @param step_slice The number of steps in each slice.
+     * @param timeout_policy How the jobs' time budgets are enforced.
+     * @param summary_only Whether to skip exporting the jobs' statistics (output) files.
+     */
+    SliceScheduler(const std::vector<Job>& jobs,
+                   std::size_t num_threads,
+                   std::size_t step_slice,
+                   const TimeoutPolicy& timeout_policy,
+                   bool summary_only);
+
+    SliceScheduler(const SliceScheduler& slice_scheduler) = delete;
+    SliceScheduler& operator=(const SliceScheduler& slice_scheduler) = delete;
+
+    /**
+     * @brief Runs all jobs. Returns only after all jobs finished (gracefully or due to a timeout).
+     */
+    void run();
+
+    /**
+     * @brief Returns the result of a given job (valid after run() returned).
+     */
+    const JobResult& getResult(std::size_t job_index) const { return results.at(job_index); }
+};
+
+#endif /* SLICE_SCHEDULER_H_ */
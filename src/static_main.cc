@@ -0,0 +1,185 @@
+#include <map>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdlib>
+#include <exception>
+#include <time.h>
+
+#include "simulator/simulator.h"
+
+#include "algorithm/a/greedy_algorithm.h"
+#include "algorithm/b/dfs_algorithm.h"
+
+#include "output_handler.h"
+#include "input_handler.h"
+#include "memory_tracker.h"
+#include "job.h"
+
+/**
+ * myrobot_static - simulates the in-tree algorithms, linked statically into the executable (for benchmark and regression runs).
+ *
+ * Each algorithm is simulated by its concrete (`final`) type, so the simulator's algorithm calls are dispatched statically
+ * and may be inlined across modules (the executable is built with link time optimization, when supported).
+ * Simulations run one after the other on the main thread, with no timeouts (the in-tree algorithms are trusted).
+ * Output files are the same as myrobot's.
+ */
+
+namespace Constants
+{
+    const std::string kDefaultAlgorithmPath = ".";
+    const std::string kDefaultHousePath = ".";
+    const std::size_t kDefaultNumThreads = 1;
+    const bool kDefaultSummaryOnly = false;
+    const std::size_t kDefaultWallCeilingFactor = 10;
+
+    const std::string kSimulationError1 = "[house=";
+    const std::string kSimulationError2 = "]";
+}
+
+using StaticSimulation = JobResult (*)(const std::string& algorithm_name, const HouseFile& house_file, const Arguments& arguments);
+
+std::chrono::nanoseconds readThreadCpuClock()
+{
+    timespec cpu_time;
+    if (0 != clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time))
+    {
+        return std::chrono::nanoseconds::zero();
+    }
+
+    return std::chrono::seconds(cpu_time.tv_sec) + std::chrono::nanoseconds(cpu_time.tv_nsec);
+}
+
+/**
+ * @brief Simulates a single house by a given concrete algorithm type (and exports its statistics unless summary_only).
+ */
+template <typename ConcreteAlgorithm>
+JobResult simulateStatic(const std::string& algorithm_name, const HouseFile& house_file, const Arguments& arguments)
+{
+    ConcreteAlgorithm algorithm;
+    Simulator simulator(house_file);
+    simulator.enableCycleDetection(arguments.cycle_check_interval);
+    simulator.enableStepTiming(arguments.step_latency);
+    simulator.setAlgorithm(algorithm);
+
+    JobResult result;
+
+    MemoryTracker::resetThreadUsage();
+    std::chrono::nanoseconds start_cpu_time = readThreadCpuClock();
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    try
+    {
+        result.score = simulator.run(algorithm);
+    }
+
+    catch (const std::exception& exception)
+    {
+        result.score = simulator.getTimeoutScore();
+        result.algorithm_error = Constants::kSimulationError1 + house_file.name + Constants::kSimulationError2 + exception.what() + "\n";
+    }
+
+    result.performance.wall_time = std::chrono::steady_clock::now() - start_time;
+    result.performance.cpu_time = readThreadCpuClock() - start_cpu_time;
+    result.performance.time_budget = std::chrono::milliseconds(simulator.getMaxSteps());
+    result.performance.peak_memory_bytes = static_cast<std::size_t>(MemoryTracker::getThreadUsage().peak_bytes.load(std::memory_order_relaxed));
+
+    const SimulationStatistics& statistics = simulator.getSimulationStatistics();
+    result.performance.num_steps = statistics.num_steps_taken;
+
+    if (nullptr != simulator.getStepLatencies())
+    {
+        result.performance.step_latencies = simulator.getStepLatencies()->getSummary();
+    }
+
+    result.performance.planner_stats = simulator.getPlannerStats();
+
+    if (!arguments.summary_only)
+    {
+        OutputHandler::exportStatistics(algorithm_name, house_file.name, statistics, result.score);
+    }
+
+    return result;
+}
+
+/**
+ * @brief The statically linked algorithms (the same names they're registered by as plugins).
+ */
+const std::vector<std::pair<std::string, StaticSimulation>> kStaticAlgorithms = {
+    {"GreedyAlgorithm", &simulateStatic<GreedyAlgorithm>},
+    {"DFSAlgorithm", &simulateStatic<DFSAlgorithm>}
+};
+
+void runStatic(const Arguments& arguments)
+{
+    std::vector<std::filesystem::path> house_paths;
+    std::vector<HouseFile> house_files;
+
+    InputHandler::findHouses(arguments.house_path, house_paths);
+    InputHandler::readHouses(house_paths, house_files);
+
+    std::map<std::string, std::map<std::string, std::size_t>> task_scores;
+    std::map<std::string, std::map<std::string, TaskPerformance>> task_performance;
+
+    for (const auto& [algorithm_name, simulate] : kStaticAlgorithms)
+    {
+        std::string algorithm_errors;
+
+        for (const auto& house_file : house_files)
+        {
+            JobResult result = simulate(algorithm_name, house_file, arguments);
+
+            algorithm_errors += result.algorithm_error;
+            task_scores[algorithm_name].insert(std::make_pair(house_file.name, result.score));
+            task_performance[algorithm_name].insert(std::make_pair(house_file.name, result.performance));
+        }
+
+        OutputHandler::exportError(algorithm_name, algorithm_errors);
+    }
+
+    OutputHandler::exportSummary(task_scores);
+    OutputHandler::exportPerformance(task_performance);
+    OutputHandler::exportStepLatencies(task_performance);
+    OutputHandler::exportPlannerStats(task_performance);
+}
+
+int main(int argc, char* argv[])
+{
+    Arguments arguments = {
+        .house_path = Constants::kDefaultHousePath,
+        .algorithm_path = Constants::kDefaultAlgorithmPath,
+        .num_threads = Constants::kDefaultNumThreads,
+        .summary_only = Constants::kDefaultSummaryOnly,
+        .shard = std::nullopt,
+        .merge = false,
+        .cpu_timeout = false,
+        .wall_ceiling_factor = Constants::kDefaultWallCeilingFactor,
+        .isolate = false,
+        .daemon_socket = std::nullopt,
+        .step_slice = 0,
+        .replay_path = std::nullopt,
+        .cycle_check_interval = 0,
+        .batch_size = 0,
+        .step_latency = false,
+        .trace_path = std::nullopt,
+        .metrics_path = std::nullopt
+    };
+
+    try
+    {
+        bool is_success = InputHandler::parseCmdArguments(argc, argv, arguments);
+        if (is_success)
+        {
+            runStatic(arguments);
+        }
+    }
+
+    catch(const std::exception& exception)
+    {
+        OutputHandler::printError("Main", exception.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -3,6 +3,7 @@
 #include <sched.h>
 
 #include "output_handler.h"
+#include "common/tracepoints.h"
 
 void Task::setIdlePriority(pthread_t& thread_handler)
 {
@@ -18,11 +19,36 @@ void Task::timeoutHandler(const boost::system::error_code& error_code,
     // Make sure timer was not cancelled.
     if (!error_code)
     {
+        if (task.is_task_ended.load())
+        {
+            return;
+        }
+
+        if (task.timeout_policy.is_cpu_time)
+        {
+            // CPU time never advances faster than wall-clock time, so the remaining CPU budget is a safe re-arm duration.
+            std::chrono::nanoseconds remaining_budget = task.getRemainingCpuBudget();
+            if (remaining_budget > std::chrono::nanoseconds::zero())
+            {
+                task.armTimer(remaining_budget, thread_handler);
+                return;
+            }
+        }
+
         bool expected_value = false;
         bool is_simulation_timeout = task.is_task_ended.compare_exchange_strong(expected_value, true);
         if (is_simulation_timeout)
         {
+            if (nullptr != task.run_metrics)
+            {
+                task.run_metrics->num_timeouts.fetch_add(1, std::memory_order_relaxed);
+                task.run_metrics->num_finished.fetch_add(1, std::memory_order_relaxed);
+            }
+
             task.score = task.simulator.getTimeoutScore();
+            VACUUM_TRACEPOINT3(task__timeout, task.algorithm_name.c_str(), task.house_name.c_str(), task.score);
+            task.stopMeasuring(true);
+            task.traceSimulation();
             task.onTeardown();
             setIdlePriority(thread_handler);
         }
@@ -33,37 +59,120 @@ Task::Task(const std::string& algorithm_name,
            std::unique_ptr<AbstractAlgorithm>&& algorithm_pointer,
            const HouseFile& house_file,
            std::function<void()> onTeardown,
-           boost::asio::io_context& timer_context)
+           boost::asio::io_context& timer_context,
+           const TimeoutPolicy& timeout_policy,
+           std::size_t cycle_check_interval,
+           bool is_step_timed,
+           RunMetrics* run_metrics)
     : algorithm_name(algorithm_name),
       algorithm_pointer(std::move(algorithm_pointer)),
       house_name(house_file.name),
       simulator(house_file),
       is_task_ended(false),
       onTeardown(onTeardown),
-      timer_context(timer_context)
+      run_metrics(run_metrics),
+      timeout_policy(timeout_policy),
+      timer_context(timer_context),
+      runtime_timer(timer_context),
+      worker_memory_usage(nullptr),
+      worker_thread_id(0)
 {
+    simulator.enableCycleDetection(cycle_check_interval);
+    simulator.enableStepTiming(is_step_timed);
     simulator.setAlgorithm(*(this->algorithm_pointer));
     max_duration = simulator.getMaxSteps();
+    performance.time_budget = std::chrono::milliseconds(max_duration);
 }
 
-void Task::setUpTask(boost::asio::steady_timer& runtime_timer)
+std::chrono::nanoseconds Task::readCpuClock(clockid_t cpu_clock)
 {
-    // Set-up a timeout timer for the task simulation
-    runtime_timer.expires_after(boost::asio::chrono::milliseconds(max_duration));
-    auto current_thread = pthread_self();
-    runtime_timer.async_wait([this, current_thread](const boost::system::error_code& error_code) {
-        timeoutHandler(error_code, *this, current_thread);
+    timespec cpu_time;
+    if (0 != clock_gettime(cpu_clock, &cpu_time))
+    {
+        return std::chrono::nanoseconds::zero();
+    }
+
+    return std::chrono::seconds(cpu_time.tv_sec) + std::chrono::nanoseconds(cpu_time.tv_nsec);
+}
+
+void Task::startMeasuring()
+{
+    MemoryTracker::resetThreadUsage();
+    worker_memory_usage = &MemoryTracker::getThreadUsage();
+    worker_thread_id = TraceRecorder::getThreadId();
+
+    if (0 != pthread_getcpuclockid(pthread_self(), &worker_cpu_clock))
+    {
+        worker_cpu_clock = CLOCK_THREAD_CPUTIME_ID;
+    }
+
+    start_cpu_time = readCpuClock(worker_cpu_clock);
+    start_time = std::chrono::steady_clock::now();
+}
+
+void Task::stopMeasuring(bool is_timeout)
+{
+    performance.wall_time = std::chrono::steady_clock::now() - start_time;
+    performance.is_timeout = is_timeout;
+
+    performance.cpu_time = readCpuClock(worker_cpu_clock) - start_cpu_time;
+    performance.peak_memory_bytes = static_cast<std::size_t>(worker_memory_usage->peak_bytes.load(std::memory_order_relaxed));
+
+    // On a timeout - the latencies recorded so far (the worker thread may still be recording)
+    const StepLatencyHistogram* step_latencies = simulator.getStepLatencies();
+    if (nullptr != step_latencies)
+    {
+        performance.step_latencies = step_latencies->getSummary();
+    }
+
+    // On a timeout - the worker thread may still be running the algorithm
+    if (!is_timeout)
+    {
+        performance.planner_stats = simulator.getPlannerStats();
+    }
+}
+
+std::chrono::nanoseconds Task::getRemainingCpuBudget() const
+{
+    std::chrono::nanoseconds budget = std::chrono::milliseconds(max_duration);
+    std::chrono::nanoseconds wall_ceiling = budget * timeout_policy.wall_ceiling_factor;
+
+    std::chrono::nanoseconds elapsed_cpu_time = readCpuClock(worker_cpu_clock) - start_cpu_time;
+    std::chrono::nanoseconds elapsed_wall_time = std::chrono::steady_clock::now() - start_time;
+
+    if (elapsed_cpu_time >= budget || elapsed_wall_time >= wall_ceiling)
+    {
+        return std::chrono::nanoseconds::zero();
+    }
+
+    return std::min(budget - elapsed_cpu_time, wall_ceiling - elapsed_wall_time);
+}
+
+void Task::armTimer(std::chrono::nanoseconds duration, pthread_t thread_handler)
+{
+    runtime_timer.expires_after(duration);
+    runtime_timer.async_wait([this, thread_handler](const boost::system::error_code& error_code) {
+        timeoutHandler(error_code, *this, thread_handler);
     });
 }
 
-void Task::tearDownTask(std::optional<std::size_t> simulation_score, boost::asio::steady_timer& runtime_timer)
+void Task::setUpTask()
 {
-    runtime_timer.cancel();
+    // Set-up a timeout timer for the task simulation
+    armTimer(std::chrono::milliseconds(max_duration), pthread_self());
+}
 
+void Task::tearDownTask(std::optional<std::size_t> simulation_score)
+{
     bool expected_value = false;
     bool is_finished_gracefully = is_task_ended.compare_exchange_strong(expected_value, true);
     if (is_finished_gracefully)
     {
+        // The timer may be re-armed by the event loop thread - so it's cancelled there as well.
+        boost::asio::post(timer_context, [this]() {
+            runtime_timer.cancel();
+        });
+
         if (simulation_score.has_value())
         {
             // Simulation finished successfully (with NO timeout)
@@ -76,20 +185,96 @@ void Task::tearDownTask(std::optional<std::size_t> simulation_score, boost::asio
             score = simulator.getTimeoutScore();
         }
 
+        VACUUM_TRACEPOINT4(task__end, algorithm_name.c_str(), house_name.c_str(), score, simulator.getSimulationStatistics().num_steps_taken);
+        stopMeasuring(false);
+        traceSimulation();
+
+        if (nullptr != run_metrics)
+        {
+            run_metrics->num_finished.fetch_add(1, std::memory_order_relaxed);
+        }
+
         onTeardown();
     }
 }
 
+void Task::traceSimulation() const
+{
+    if (!TraceRecorder::isEnabled())
+    {
+        return;
+    }
+
+    std::string arguments = TraceRecorder::formatArgument("algorithm", algorithm_name) + ","
+                          + TraceRecorder::formatArgument("house", house_name) + ","
+                          + TraceRecorder::formatArgument("score", score);
+
+    TraceRecorder::recordSpan("task", house_name + "-" + algorithm_name, start_time, start_time + performance.wall_time, arguments, worker_thread_id);
+
+    if (performance.is_timeout)
+    {
+        // On the event loop thread's track (the worker thread may still be running)
+        TraceRecorder::recordInstant("task", "timed out", arguments);
+    }
+}
+
+std::size_t Task::runSimulation()
+{
+    if (nullptr == run_metrics)
+    {
+        return simulator.run();
+    }
+
+    std::size_t num_steps_counted = 0;
+    std::size_t chunk_steps = 1;
+    bool is_finished = false;
+
+    // A timed out task stops at the end of its current chunk (its result is already set)
+    while (!is_finished && !is_task_ended.load(std::memory_order_relaxed))
+    {
+        std::chrono::steady_clock::time_point chunk_start_time = std::chrono::steady_clock::now();
+        is_finished = simulator.runFor(chunk_steps);
+        std::chrono::steady_clock::duration chunk_time = std::chrono::steady_clock::now() - chunk_start_time;
+
+        std::size_t num_steps_taken = simulator.getSimulationStatistics().num_steps_taken;
+        run_metrics->num_steps.fetch_add(num_steps_taken - num_steps_counted, std::memory_order_relaxed);
+        num_steps_counted = num_steps_taken;
+
+        // Algorithms' step times differ by orders of magnitude - so the chunks are sized by their time
+        if (chunk_time < kProgressInterval / 2)
+        {
+            chunk_steps = std::min(2 * chunk_steps, kMaxProgressSteps);
+        }
+
+        else if (chunk_time > 2 * kProgressInterval)
+        {
+            chunk_steps = std::max<std::size_t>(1, chunk_steps / 2);
+        }
+    }
+
+    return simulator.getSimulationStatistics().score;
+}
+
 void Task::simulatePair()
 {
-    boost::asio::steady_timer runtime_timer(timer_context);
-    setUpTask(runtime_timer);
+    TraceRecorder::setThreadName("worker");
+
+    if (nullptr != run_metrics)
+    {
+        run_metrics->num_active_workers.fetch_add(1, std::memory_order_relaxed);
+        run_metrics->num_started.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    VACUUM_TRACEPOINT2(task__start, algorithm_name.c_str(), house_name.c_str());
+
+    startMeasuring();
+    setUpTask();
 
     std::optional<std::size_t> simulation_score;
 
     try
     {
-        simulation_score = simulator.run();
+        simulation_score = runSimulation();
     }
 
     catch(const std::exception& exception)
@@ -97,5 +282,11 @@ void Task::simulatePair()
         setAlgorithmError(exception.what());
     }
 
-    tearDownTask(simulation_score, runtime_timer);
+    // Before the tear-down, which may let the queue finish
+    if (nullptr != run_metrics)
+    {
+        run_metrics->num_active_workers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    tearDownTask(simulation_score);
 }
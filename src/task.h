@@ -2,6 +2,10 @@
 #define TASK_H_
 
 #include "output_handler.h"
+#include "memory_tracker.h"
+#include "task_performance.h"
+#include "trace_recorder.h"
+#include "run_metrics.h"
 
 #include "simulator/simulator.h"
 #include "simulator/deserializer.h"
@@ -12,6 +16,7 @@
 #include <boost/system/error_code.hpp>
 
 #include <pthread.h>
+#include <time.h>
 
 #include <optional>
 #include <string>
@@ -21,6 +26,15 @@
 
 using namespace std::chrono_literals;
 
+/**
+ * @brief The TimeoutPolicy struct describes how a task's time budget (MaxSteps milliseconds) is enforced.
+ */
+struct TimeoutPolicy
+{
+    bool is_cpu_time = false;               // Whether the budget is measured in the worker thread's CPU time (instead of wall-clock time).
+    std::size_t wall_ceiling_factor = 1;    // Wall-clock ceiling (as a multiple of the budget), a safety net for CPU time budgets.
+};
+
 /**
  * Credits to Amir's demonstration
  */
@@ -29,6 +43,8 @@ class Task
     // Task Constants
     inline static const char kSimulationError1[] = "[house=";
     inline static const char kSimulationError2 = ']';
+    static constexpr const auto kProgressInterval = 10ms;      // Targeted time between progress reports (when the run's metrics are kept).
+    inline static const std::size_t kMaxProgressSteps = 1 << 20; // Maximal number of steps between progress reports.
 
     // Task Simulation Data
     const std::string& algorithm_name;
@@ -40,14 +56,25 @@ class Task
     std::jthread worker_thread;
     std::atomic<bool> is_task_ended;
     const std::function<void()> onTeardown;
+    RunMetrics* const run_metrics;                          // The run's live progress counters (null if they aren't kept).
 
     // Task Timing Utilities
     std::size_t max_duration;
+    const TimeoutPolicy timeout_policy;
     boost::asio::io_context& timer_context;
+    boost::asio::steady_timer runtime_timer;                // The task's timeout timer (only touched by the event loop thread once armed).
+
+    // Task Performance Accounting
+    std::chrono::steady_clock::time_point start_time;       // The time the simulation started at.
+    clockid_t worker_cpu_clock;                             // CPU time clock of the worker thread.
+    std::chrono::nanoseconds start_cpu_time;                // The worker thread's CPU time when the simulation started.
+    MemoryTracker::ThreadUsage* worker_memory_usage;        // Heap usage counters of the worker thread.
+    pid_t worker_thread_id;                                 // Kernel thread id of the worker thread (its trace track).
 
     // Task Results
     std::ostringstream algorithm_error_buffer;
     std::size_t score;
+    TaskPerformance performance;
 
     /**
      * @brief Sets a given thread as an IDLE.
@@ -68,6 +95,21 @@ class Task
                                Task& task,
                                pthread_t thread_handler);
 
+    /**
+     * @brief Arms the task's timeout timer.
+     * 
+     * @param duration The duration until the timer expires.
+     * @param thread_handler The worker thread of the task.
+     */
+    void armTimer(std::chrono::nanoseconds duration, pthread_t thread_handler);
+
+    /**
+     * @brief Computes how much longer the task may run before a CPU time budget timeout, bounded by the wall-clock ceiling.
+     * 
+     * @return The remaining duration (zero if the CPU time budget or the wall-clock ceiling was exhausted).
+     */
+    std::chrono::nanoseconds getRemainingCpuBudget() const;
+
     /**
      * @brief Adds an error message to the task's error buffer.
      * 
@@ -79,19 +121,52 @@ class Task
     }
 
     /**
-     * @brief Task set-up function to be executed before performing the task.
+     * @brief Reads a given CPU time clock.
      * 
-     * @param runtime_timer The task's timeout timer.
+     * @param cpu_clock The clock to be read.
+     * 
+     * @return The CPU time of the clock (or zero, if it couldn't be read).
      */
-    void setUpTask(boost::asio::steady_timer& runtime_timer);
+    static std::chrono::nanoseconds readCpuClock(clockid_t cpu_clock);
+
+    /**
+     * @brief Starts measuring the task's resources usage.
+     * Must be called by the worker thread (the measured thread).
+     */
+    void startMeasuring();
+
+    /**
+     * @brief Stops measuring the task's resources usage, and stores the results into the task's performance report.
+     * May be called by any thread (while the worker thread is still alive).
+     * 
+     * @param is_timeout Whether or not the measuring stopped due to a timeout.
+     */
+    void stopMeasuring(bool is_timeout);
+
+    /**
+     * @brief Records the task's simulation span into the run's trace (if tracing is enabled), on the worker thread's track.
+     * May be called by any thread (after stopMeasuring()).
+     */
+    void traceSimulation() const;
+
+    /**
+     * @brief Runs the simulation - in chunks of about kProgressInterval each if the run's metrics are kept, counting their steps.
+     *
+     * @return The resultant score of the simulation.
+     */
+    std::size_t runSimulation();
+
+    /**
+     * @brief Task set-up function to be executed before performing the task.
+     */
+    void setUpTask();
 
     /**
      * @brief Task tear-down function to be executed after performing the task.
      * 
      * @param simulation_score The resultant score of the task (if there's no score std::nullopt).
-     * @param runtime_timer The task's timeout timer.
      */
-    void tearDownTask(std::optional<std::size_t> simulation_score, boost::asio::steady_timer& runtime_timer);
+    void tearDownTask(std::optional<std::size_t> simulation_score);
 
     /**
      * @brief Simulates an house - algorithm pair.
@@ -105,7 +180,11 @@ public:
          std::unique_ptr<AbstractAlgorithm>&& algorithm_pointer,
          const HouseFile& house_file,
          std::function<void()> onTeardown,
-         boost::asio::io_context& timer_context);
+         boost::asio::io_context& timer_context,
+         const TimeoutPolicy& timeout_policy = TimeoutPolicy(),
+         std::size_t cycle_check_interval = 0,
+         bool is_step_timed = false,
+         RunMetrics* run_metrics = nullptr);
 
     /**
      * @brief Runs the task.
@@ -127,6 +206,17 @@ public:
      */
     const SimulationStatistics& getStatistics() { return simulator.getSimulationStatistics(); }
 
+    /**
+     * @brief Returns task's resources usage report.
+     * 
+     * @return The task performance report.
+     */
+    const TaskPerformance& getPerformance()
+    {
+        performance.num_steps = simulator.getSimulationStatistics().num_steps_taken;
+        return performance;
+    }
+
     /**
      * @brief Returns task's simulated algorithm name.
      * 
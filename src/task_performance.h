@@ -0,0 +1,38 @@
+#ifndef TASK_PERFORMANCE_H_
+#define TASK_PERFORMANCE_H_
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+#include "simulator/step_latency_histogram.h"
+
+#include "common/planner_stats_algorithm.h"
+
+/**
+ * @brief The TaskPerformance struct represents the resource usage report of a single task (algorithm - house pair).
+ */
+struct TaskPerformance
+{
+    std::chrono::nanoseconds wall_time{0};          // Elapsed (wall-clock) time of the simulation.
+    std::chrono::nanoseconds cpu_time{0};           // CPU time consumed by the simulating thread.
+    std::chrono::milliseconds time_budget{0};       // The simulation's timeout (MaxSteps milliseconds).
+    std::size_t num_steps = 0;                      // Number of steps simulated.
+    std::size_t peak_memory_bytes = 0;              // High-water mark of heap bytes allocated by the simulating thread.
+    bool is_timeout = false;                        // Whether or not the simulation timed out.
+    std::optional<StepLatencySummary> step_latencies;   // The algorithm's step call latencies (when its steps were timed).
+    std::optional<PlannerStats> planner_stats;          // The algorithm's planner work (if it reports one, and wasn't stopped mid-step).
+
+    /**
+     * @brief Computes the simulation speed.
+     *
+     * @return The number of simulated steps per (wall-clock) second.
+     */
+    double getStepsPerSecond() const
+    {
+        double seconds = std::chrono::duration<double>(wall_time).count();
+        return (seconds > 0) ? static_cast<double>(num_steps) / seconds : 0.0;
+    }
+};
+
+#endif /* TASK_PERFORMANCE_H_ */
@@ -1,8 +1,10 @@
 #include "task_queue.h"
+#include "trace_recorder.h"
 
 void TaskQueue::createTimer()
 {
     timer_thread = std::jthread([this]() {
+        TraceRecorder::setThreadName("timeouts");
         this->timer_context.run();
     });
 
@@ -13,18 +15,37 @@ void TaskQueue::createTimer()
      */
 }
 
-TaskQueue::TaskQueue(std::size_t number_of_tasks, std::size_t number_of_threads)
+TaskQueue::TaskQueue(std::size_t number_of_tasks, std::size_t number_of_threads, const TimeoutPolicy& timeout_policy)
     : num_tasks(number_of_tasks),
       todo_tasks_counter(number_of_tasks),
       active_threads_semaphore(number_of_threads),
+      timeout_policy(timeout_policy),
       work_guard(boost::asio::make_work_guard(timer_context))
 {
     createTimer();
 }
 
+TaskQueue::~TaskQueue()
+{
+    timer_context.stop();
+}
+
+void TaskQueue::enableRunMetrics()
+{
+    if (!tasks.empty())
+    {
+        throw std::logic_error("TaskQueue::enableRunMetrics() was called after a task was inserted.");
+    }
+
+    run_metrics = std::make_unique<RunMetrics>();
+    run_metrics->num_tasks.store(num_tasks, std::memory_order_relaxed);
+}
+
 void TaskQueue::insertTask(const std::string& algorithm_name,
                            std::unique_ptr<AbstractAlgorithm>&& algorithm_pointer,
-                           const HouseFile& house_file)
+                           const HouseFile& house_file,
+                           std::size_t cycle_check_interval,
+                           bool is_step_timed)
 {
     if (tasks.size() >= num_tasks)
     {
@@ -37,12 +58,21 @@ void TaskQueue::insertTask(const std::string& algorithm_name,
         this->active_threads_semaphore.release();
     };
 
+    if (TraceRecorder::isEnabled())
+    {
+        TraceRecorder::recordInstant("task", "queued", TraceRecorder::formatArgument("algorithm", algorithm_name) + "," + TraceRecorder::formatArgument("house", house_file.name));
+    }
+
     tasks.emplace_back(
         algorithm_name,
         std::move(algorithm_pointer),
         house_file,
         taskTearDown,
-        timer_context
+        timer_context,
+        timeout_policy,
+        cycle_check_interval,
+        is_step_timed,
+        run_metrics.get()
     );
 }
 
@@ -56,12 +86,18 @@ void TaskQueue::run()
     for (auto& task : tasks)
     {
         // Semaphore used to check we can spawn another task without exceeding the maximal threads limit.
-        active_threads_semaphore.acquire();
+        {
+            TraceRecorder::ScopedSpan acquire_span("task", "wait for a worker");
+            active_threads_semaphore.acquire();
+        }
+
         task.run();
     }
 
     // Wait for all tasks to finish running (gracefully or due to a timeout).
     todo_tasks_counter.wait();
 
+    // No timeouts are left to handle.
     timer_context.stop();
+    timer_thread.join();
 }
@@ -2,10 +2,12 @@
 #define TASK_QUEUE_H_
 
 #include "task.h"
+#include "run_metrics.h"
 #include "common/abstract_algorithm.h"
 
 #include <boost/asio.hpp>
 
+#include <memory>
 #include <semaphore>
 #include <thread>
 #include <latch>
@@ -17,22 +19,44 @@ class TaskQueue
     std::size_t num_tasks;
     std::latch todo_tasks_counter;
     std::counting_semaphore<> active_threads_semaphore; // An up-to-date counter of the number of active WORKER (task) threads.
+    const TimeoutPolicy timeout_policy;                 // How the tasks' time budgets are enforced.
 
     // Queue Timing Utilities
-    std::jthread timer_thread;                          // A thread running the event loop (for task timeouts).
     boost::asio::io_context timer_context;              // Represents the event loop object.
     boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_guard;    // Prevents event loop from stopping with no active events.
 
     // Queue Contents
     std::list<Task> tasks;                            // The tasks in the queue to be executed.
 
+    // Queue Progress
+    std::unique_ptr<RunMetrics> run_metrics;          // The live progress counters of the tasks (null if they aren't kept).
+
+    // Declared last - so it's joined before any member its event loop uses is destroyed
+    std::jthread timer_thread;                          // A thread running the event loop (for task timeouts).
+
     /**
      * @brief Intializes the shared tasks timer of the task queue (for timeouts).
      */
     void createTimer();
 
 public:
-    TaskQueue(std::size_t number_of_tasks, std::size_t number_of_threads);
+    TaskQueue(std::size_t number_of_tasks, std::size_t number_of_threads, const TimeoutPolicy& timeout_policy = TimeoutPolicy());
+
+    /**
+     * @brief Stops the event loop, so its thread can be joined (also when run() threw, or wasn't called).
+     */
+    ~TaskQueue();
+
+    /**
+     * @brief Keeps the live progress counters of the tasks (see getRunMetrics()).
+     * Must be called before any task is inserted.
+     */
+    void enableRunMetrics();
+
+    /**
+     * @brief Returns the live progress counters of the tasks (null if they aren't kept).
+     */
+    const RunMetrics* getRunMetrics() const { return run_metrics.get(); }
 
     /**
      * @brief Inserts a task into the task queue.
@@ -40,10 +64,14 @@ public:
      * @param algorithm_name The name of the algorithm to be executed by the inserted task.
      * @param algorithm_pointer The pointer to the algorithm to be executed by the inserted task.
      * @param house_file The house file to be executed by the inserted task.
+     * @param cycle_check_interval The task's cycle detection interval (0 disables it, see Simulator::enableCycleDetection()).
+     * @param is_step_timed Whether the task's algorithm step calls are timed (see Simulator::enableStepTiming()).
      */
     void insertTask(const std::string& algorithm_name,
                     std::unique_ptr<AbstractAlgorithm>&& algorithm_pointer,
-                    const HouseFile& house_file);
+                    const HouseFile& house_file,
+                    std::size_t cycle_check_interval = 0,
+                    bool is_step_timed = false);
 
     /**
      * @brief Runs all tasks in the task queue.
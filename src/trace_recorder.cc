@@ -0,0 +1,232 @@
+#include "trace_recorder.h"
+
+#include <mutex>
+#include <memory>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * @brief The events buffer of a single thread.
+     */
+    struct ThreadBuffer
+    {
+        std::mutex mutex;                               // Taken by the owning thread to append, and by exportTrace() to read.
+        std::vector<TraceRecorder::Event> events;
+    };
+
+    std::mutex buffers_mutex;                           // Guards the buffers registry.
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers; // All threads' buffers (kept after their threads exit).
+    thread_local ThreadBuffer* thread_buffer = nullptr;
+
+    /**
+     * @brief Writes a string as a JSON string (quoted and escaped).
+     */
+    void writeJsonString(std::ostream& output, const std::string& value)
+    {
+        output << '"';
+
+        for (char character : value)
+        {
+            if ('"' == character || '\\' == character)
+            {
+                output << '\\' << character;
+            }
+
+            else if (static_cast<unsigned char>(character) < 0x20)
+            {
+                char escaped[7];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(character));
+                output << escaped;
+            }
+
+            else
+            {
+                output << character;
+            }
+        }
+
+        output << '"';
+    }
+}
+
+TraceRecorder::ScopedSpan::ScopedSpan(const char* category, std::string name, std::string arguments)
+    : is_recording(TraceRecorder::isEnabled()),
+      category(category)
+{
+    if (is_recording)
+    {
+        this->name = std::move(name);
+        this->arguments = std::move(arguments);
+        start_time = Clock::now();
+    }
+}
+
+TraceRecorder::ScopedSpan::~ScopedSpan()
+{
+    if (is_recording)
+    {
+        TraceRecorder::recordSpan(category, std::move(name), start_time, Clock::now(), std::move(arguments));
+    }
+}
+
+void TraceRecorder::appendEvent(Event&& event)
+{
+    if (nullptr == thread_buffer)
+    {
+        std::lock_guard<std::mutex> registry_lock(buffers_mutex);
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        thread_buffer = buffers.back().get();
+    }
+
+    std::lock_guard<std::mutex> buffer_lock(thread_buffer->mutex);
+    thread_buffer->events.push_back(std::move(event));
+}
+
+void TraceRecorder::enable()
+{
+    trace_start_time = Clock::now();
+    is_enabled.store(true, std::memory_order_relaxed);
+}
+
+pid_t TraceRecorder::getThreadId()
+{
+    // Cached, as it's a syscall
+    thread_local pid_t thread_id = gettid();
+    return thread_id;
+}
+
+void TraceRecorder::setThreadName(const std::string& thread_name)
+{
+    if (isEnabled())
+    {
+        appendEvent({
+            .name = "thread_name",
+            .category = "",
+            .phase = 'M',
+            .start_time = trace_start_time,
+            .duration = Clock::duration::zero(),
+            .thread_id = getThreadId(),
+            .arguments = formatArgument("name", thread_name)
+        });
+    }
+}
+
+void TraceRecorder::recordSpan(const char* category,
+                               std::string name,
+                               Clock::time_point start_time,
+                               Clock::time_point end_time,
+                               std::string arguments,
+                               pid_t thread_id)
+{
+    if (isEnabled())
+    {
+        appendEvent({
+            .name = std::move(name),
+            .category = category,
+            .phase = 'X',
+            .start_time = start_time,
+            .duration = end_time - start_time,
+            .thread_id = thread_id,
+            .arguments = std::move(arguments)
+        });
+    }
+}
+
+void TraceRecorder::recordInstant(const char* category, std::string name, std::string arguments, pid_t thread_id)
+{
+    if (isEnabled())
+    {
+        appendEvent({
+            .name = std::move(name),
+            .category = category,
+            .phase = 'i',
+            .start_time = Clock::now(),
+            .duration = Clock::duration::zero(),
+            .thread_id = thread_id,
+            .arguments = std::move(arguments)
+        });
+    }
+}
+
+std::string TraceRecorder::formatArgument(const std::string& key, const std::string& value)
+{
+    std::ostringstream argument;
+    writeJsonString(argument, key);
+    argument << ':';
+    writeJsonString(argument, value);
+    return argument.str();
+}
+
+void TraceRecorder::exportTrace(const std::filesystem::path& trace_path)
+{
+    using Microseconds = std::chrono::duration<double, std::micro>;
+
+    std::vector<Event> events;
+
+    {
+        std::lock_guard<std::mutex> registry_lock(buffers_mutex);
+        for (const auto& buffer : buffers)
+        {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            events.insert(events.end(), buffer->events.begin(), buffer->events.end());
+        }
+    }
+
+    std::stable_sort(events.begin(), events.end(), [](const Event& first, const Event& second)
+    {
+        return first.start_time < second.start_time;
+    });
+
+    std::ofstream trace_file(trace_path, std::ios::trunc);
+    if (!trace_file.is_open())
+    {
+        throw std::runtime_error("Couldn't open trace file \"" + trace_path.string() + "\"");
+    }
+
+    pid_t process_id = getpid();
+
+    trace_file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    trace_file << std::fixed << std::setprecision(3);
+
+    for (std::size_t i = 0; i < events.size(); i++)
+    {
+        const Event& event = events[i];
+
+        trace_file << (0 == i ? "\n" : ",\n") << "{\"name\":";
+        writeJsonString(trace_file, event.name);
+        trace_file << ",\"cat\":";
+        writeJsonString(trace_file, event.category);
+        trace_file << ",\"ph\":\"" << event.phase << "\""
+                   << ",\"ts\":" << Microseconds(event.start_time - trace_start_time).count()
+                   << ",\"pid\":" << process_id
+                   << ",\"tid\":" << event.thread_id;
+
+        if ('X' == event.phase)
+        {
+            trace_file << ",\"dur\":" << Microseconds(event.duration).count();
+        }
+
+        else if ('i' == event.phase)
+        {
+            trace_file << ",\"s\":\"t\"";
+        }
+
+        trace_file << ",\"args\":{" << event.arguments << "}}";
+    }
+
+    trace_file << "\n]}\n";
+
+    if (!trace_file.good())
+    {
+        throw std::runtime_error("Couldn't write trace file \"" + trace_path.string() + "\"");
+    }
+}
@@ -0,0 +1,147 @@
+#ifndef TRACE_RECORDER_H_
+#define TRACE_RECORDER_H_
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+#include <sys/types.h>
+
+/**
+ * @brief The TraceRecorder class records a timeline of the run, exported as a Chrome trace-event JSON file
+ * (viewable by `chrome://tracing` or https://ui.perfetto.dev).
+ *
+ * Recording is disabled unless enable() is called - then every thread records its events into a buffer of its own
+ * (registered once per thread, and locked by its owner only, except while exporting), and the buffers are merged
+ * into a single trace by exportTrace(). Each thread is a track of the trace (named by setThreadName()).
+ */
+class TraceRecorder
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief A single trace event - a span of time (a Chrome trace "complete" event), or an instant.
+     */
+    struct Event
+    {
+        std::string name;
+        const char* category;
+        char phase;                         // 'X' for a span, 'i' for an instant, 'M' for the thread name metadata.
+        Clock::time_point start_time;
+        Clock::duration duration;           // Zero for an instant.
+        pid_t thread_id;                    // The track the event is shown on (not necessarily the recording thread).
+        std::string arguments;              // The event's arguments - the fields of a JSON object (e.g. `"house":"a"`), or empty.
+    };
+
+    /**
+     * @brief Records a span from its construction to its destruction (if recording is enabled at its construction).
+     */
+    class ScopedSpan
+    {
+        bool is_recording;
+        const char* category;
+        std::string name;
+        std::string arguments;
+        Clock::time_point start_time;
+
+    public:
+        ScopedSpan(const char* category, std::string name, std::string arguments = std::string());
+        ~ScopedSpan();
+
+        ScopedSpan(const ScopedSpan&) = delete;
+        ScopedSpan& operator=(const ScopedSpan&) = delete;
+    };
+
+private:
+    inline static std::atomic<bool> is_enabled = false;
+    inline static Clock::time_point trace_start_time;      // The time recording was enabled at (the trace's zero time).
+
+    /**
+     * @brief Appends an event to the calling thread's buffer (registering the buffer on the thread's first event).
+     */
+    static void appendEvent(Event&& event);
+
+public:
+    /**
+    * @brief Deleted deault empty constructor.
+    *
+    * The default empty constructor is deleted since it's useless, as all the TraceRecorder member functions are `static`.
+    */
+    TraceRecorder() = delete;
+
+    /**
+     * @brief Enables recording (the trace's zero time is now). Must be called before any other thread records.
+     */
+    static void enable();
+
+    /**
+     * @brief Checks whether recording is enabled (events recorded while it's disabled are ignored).
+     */
+    static bool isEnabled() { return is_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the (kernel) thread id of the calling thread.
+     */
+    static pid_t getThreadId();
+
+    /**
+     * @brief Names the calling thread's track.
+     */
+    static void setThreadName(const std::string& thread_name);
+
+    /**
+     * @brief Records a span of time.
+     *
+     * @param category The event's category (e.g. `task`).
+     * @param name The event's name.
+     * @param start_time The time the span started at.
+     * @param end_time The time the span ended at.
+     * @param arguments The event's arguments (see Event::arguments).
+     * @param thread_id The track to show the span on (the calling thread's, by default).
+     */
+    static void recordSpan(const char* category,
+                           std::string name,
+                           Clock::time_point start_time,
+                           Clock::time_point end_time,
+                           std::string arguments = std::string(),
+                           pid_t thread_id = getThreadId());
+
+    /**
+     * @brief Records an instant (at the current time).
+     *
+     * @param category The event's category (e.g. `task`).
+     * @param name The event's name.
+     * @param arguments The event's arguments (see Event::arguments).
+     * @param thread_id The track to show the instant on (the calling thread's, by default).
+     */
+    static void recordInstant(const char* category, std::string name, std::string arguments = std::string(), pid_t thread_id = getThreadId());
+
+    /**
+     * @brief Formats a string argument of an event (as a JSON object field).
+     *
+     * @param key The argument's key.
+     * @param value The argument's value (escaped as a JSON string).
+     */
+    static std::string formatArgument(const std::string& key, const std::string& value);
+
+    /**
+     * @brief Formats a numeric argument of an event (as a JSON object field).
+     */
+    static std::string formatArgument(const std::string& key, std::size_t value) { return "\"" + key + "\":" + std::to_string(value); }
+
+    /**
+     * @brief Merges all threads' buffers, and writes them as a Chrome trace-event JSON file.
+     *
+     * Events recorded afterwards are still recorded (and exported by the next call).
+     *
+     * @param trace_path The path of the trace file to be written.
+     * @throws std::runtime_error If the trace file couldn't be written.
+     */
+    static void exportTrace(const std::filesystem::path& trace_path);
+};
+
+#endif /* TRACE_RECORDER_H_ */
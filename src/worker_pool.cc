@@ -0,0 +1,420 @@
+#include "worker_pool.h"
+
+#include "output_handler.h"
+#include "memory_tracker.h"
+
+#include "simulator/simulator.h"
+
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+    std::int64_t readClock(clockid_t clock)
+    {
+        timespec time;
+        if (0 != clock_gettime(clock, &time))
+        {
+            return 0;
+        }
+
+        return static_cast<std::int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+    }
+}
+
+WorkerPool::WorkerPool(const std::vector<Job>& jobs,
+                       std::size_t num_workers,
+                       const TimeoutPolicy& timeout_policy,
+                       bool summary_only,
+                       ResultCallback on_result)
+    : jobs(jobs),
+      num_workers(std::max<std::size_t>(1, std::min(num_workers, jobs.size()))),
+      timeout_policy(timeout_policy),
+      summary_only(summary_only),
+      on_result(std::move(on_result)),
+      workers(this->num_workers),
+      results(jobs.size())
+{}
+
+WorkerPool::~WorkerPool()
+{
+    for (const Worker& worker : workers)
+    {
+        if (worker.pid > 0)
+        {
+            kill(worker.pid, SIGKILL);
+            waitpid(worker.pid, nullptr, 0);
+        }
+    }
+
+    if (nullptr != shared_state)
+    {
+        sem_destroy(&shared_state->results_semaphore);
+    }
+
+    if (nullptr != shared_memory)
+    {
+        munmap(shared_memory, shared_memory_size);
+    }
+}
+
+WorkerPool::WorkerSlot& WorkerPool::getSlot(std::size_t worker_index) const
+{
+    WorkerSlot* slots = reinterpret_cast<WorkerSlot*>(shared_state + 1);
+    return slots[worker_index];
+}
+
+void WorkerPool::spawnWorker(std::size_t worker_index)
+{
+    WorkerSlot& slot = getSlot(worker_index);
+    slot.current_task.store(kIdle);
+    slot.ring_head.store(0);
+    slot.ring_tail.store(0);
+
+    // Don't let the worker inherit (and later re-flush) the parent's buffered output.
+    std::cout.flush();
+    std::cerr.flush();
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        throw std::runtime_error("WorkerPool couldn't fork a worker process: " + std::string(std::strerror(errno)));
+    }
+
+    if (0 == pid)
+    {
+        workerMain(worker_index);
+    }
+
+    workers[worker_index] = Worker{.pid = pid, .is_killed = false};
+}
+
+void WorkerPool::workerMain(std::size_t worker_index)
+{
+    // Make sure no worker outlives the parent.
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+    WorkerSlot& slot = getSlot(worker_index);
+
+    // Nothing may unwind out of here - it would resume the parent's (forked) call stack, and its error handlers, in the worker.
+    try
+    {
+        while (true)
+        {
+            std::size_t task_index = shared_state->next_task.fetch_add(1);
+            if (task_index >= jobs.size())
+            {
+                break;
+            }
+
+            simulateJob(slot, task_index);
+        }
+    }
+
+    catch (const std::exception& exception)
+    {
+        // The parent reaps the worker, and fails its in-flight task as a crash.
+        OutputHandler::printError("WorkerPool", exception.what());
+        _exit(EXIT_FAILURE);
+    }
+
+    catch (...)
+    {
+        _exit(EXIT_FAILURE);
+    }
+
+    // Skip the parent's (inherited) static destructors and atexit handlers.
+    _exit(EXIT_SUCCESS);
+}
+
+void WorkerPool::simulateJob(WorkerSlot& slot, std::size_t task_index)
+{
+    const Job& job = jobs[task_index];
+
+    slot.start_time_ns.store(readClock(CLOCK_MONOTONIC));
+    slot.start_cpu_time_ns.store(readClock(CLOCK_PROCESS_CPUTIME_ID));
+    slot.current_task.store(static_cast<std::int64_t>(task_index));
+
+    MemoryTracker::resetThreadUsage();
+    std::int64_t start_thread_cpu_time_ns = readClock(CLOCK_THREAD_CPUTIME_ID);
+
+    std::string algorithm_error;
+    std::unique_ptr<AbstractAlgorithm> algorithm;
+    Simulator simulator(*job.house_file);
+    std::size_t score;
+
+    try
+    {
+        algorithm = job.algorithm_factory();
+        simulator.enableCycleDetection(job.cycle_check_interval);
+        simulator.enableStepTiming(job.is_step_timed);
+        simulator.setAlgorithm(*algorithm);
+        score = simulator.run();
+    }
+
+    catch (const std::exception& exception)
+    {
+        algorithm_error = formatJobError(job, exception.what());
+        score = simulator.getTimeoutScore();
+    }
+
+    // The time budget covers the simulation only - a pair which finished in time can't be killed while its results are written.
+    std::int64_t wall_time_ns = readClock(CLOCK_MONOTONIC) - slot.start_time_ns.load();
+    std::int64_t cpu_time_ns = readClock(CLOCK_THREAD_CPUTIME_ID) - start_thread_cpu_time_ns;
+    slot.current_task.store(kIdle);
+
+    const SimulationStatistics& statistics = simulator.getSimulationStatistics();
+    if (!summary_only)
+    {
+        OutputHandler::exportStatistics(job.algorithm_name, job.house_file->name, statistics, score);
+    }
+
+    // Wait for room in the ring (the parent drains it at least every poll interval).
+    std::size_t tail = slot.ring_tail.load(std::memory_order_relaxed);
+    while (tail - slot.ring_head.load(std::memory_order_acquire) >= kRingCapacity)
+    {
+        usleep(std::chrono::microseconds(kPollInterval).count());
+    }
+
+    RingEntry& entry = slot.ring[tail % kRingCapacity];
+    entry.task_index = task_index;
+    entry.score = score;
+    entry.wall_time_ns = wall_time_ns;
+    entry.cpu_time_ns = cpu_time_ns;
+    entry.num_steps = statistics.num_steps_taken;
+    entry.peak_memory_bytes = static_cast<std::size_t>(MemoryTracker::getThreadUsage().peak_bytes.load());
+    entry.step_latencies = (nullptr != simulator.getStepLatencies()) ? simulator.getStepLatencies()->getSummary() : StepLatencySummary();
+    entry.has_planner_stats = simulator.getPlannerStats().has_value();
+    entry.planner_stats = simulator.getPlannerStats().value_or(PlannerStats());
+    std::strncpy(entry.algorithm_error, algorithm_error.c_str(), kMaxErrorLength - 1);
+    entry.algorithm_error[kMaxErrorLength - 1] = '\0';
+
+    slot.ring_tail.store(tail + 1, std::memory_order_release);
+
+    sem_post(&shared_state->results_semaphore);
+}
+
+void WorkerPool::storeResult(std::size_t task_index, JobResult&& result)
+{
+    if (results[task_index].has_value())
+    {
+        return;
+    }
+
+    results[task_index] = std::move(result);
+    num_results++;
+
+    if (on_result)
+    {
+        on_result(task_index, results[task_index].value());
+    }
+}
+
+void WorkerPool::storeFailedResult(std::size_t task_index, const std::string& error_message, bool is_timeout)
+{
+    const Job& job = jobs[task_index];
+    Simulator simulator(*job.house_file);
+
+    JobResult result = {
+        .score = simulator.getTimeoutScore(),
+        .algorithm_error = error_message.empty() ? error_message : formatJobError(job, error_message),
+        .performance = TaskPerformance()
+    };
+    result.performance.time_budget = std::chrono::milliseconds(job.house_file->max_steps);
+    result.performance.is_timeout = is_timeout;
+
+    if (!summary_only && !results[task_index].has_value())
+    {
+        // The steps taken by a killed (or crashed) worker are lost with it - only the pair's score is reported.
+        OutputHandler::exportStatistics(job.algorithm_name, job.house_file->name, simulator.getSimulationStatistics(), result.score);
+    }
+
+    storeResult(task_index, std::move(result));
+}
+
+void WorkerPool::drainRing(std::size_t worker_index)
+{
+    WorkerSlot& slot = getSlot(worker_index);
+
+    std::size_t head = slot.ring_head.load(std::memory_order_relaxed);
+    std::size_t tail = slot.ring_tail.load(std::memory_order_acquire);
+
+    for (; head != tail; head++)
+    {
+        const RingEntry& entry = slot.ring[head % kRingCapacity];
+        const Job& job = jobs.at(entry.task_index);
+
+        JobResult result = {
+            .score = entry.score,
+            .algorithm_error = entry.algorithm_error,
+            .performance = TaskPerformance()
+        };
+        result.performance.wall_time = std::chrono::nanoseconds(entry.wall_time_ns);
+        result.performance.cpu_time = std::chrono::nanoseconds(entry.cpu_time_ns);
+        result.performance.time_budget = std::chrono::milliseconds(job.house_file->max_steps);
+        result.performance.num_steps = entry.num_steps;
+        result.performance.peak_memory_bytes = entry.peak_memory_bytes;
+
+        if (job.is_step_timed)
+        {
+            result.performance.step_latencies = entry.step_latencies;
+        }
+
+        if (entry.has_planner_stats)
+        {
+            result.performance.planner_stats = entry.planner_stats;
+        }
+
+        storeResult(entry.task_index, std::move(result));
+    }
+
+    slot.ring_head.store(head, std::memory_order_release);
+}
+
+void WorkerPool::enforceTimeouts()
+{
+    std::int64_t now_ns = readClock(CLOCK_MONOTONIC);
+
+    for (std::size_t worker_index = 0; worker_index < workers.size(); worker_index++)
+    {
+        Worker& worker = workers[worker_index];
+        WorkerSlot& slot = getSlot(worker_index);
+
+        std::int64_t task_index = slot.current_task.load();
+        if (worker.pid <= 0 || worker.is_killed || kIdle == task_index)
+        {
+            continue;
+        }
+
+        std::int64_t budget_ns = std::chrono::nanoseconds(std::chrono::milliseconds(jobs[task_index].house_file->max_steps)).count();
+        std::int64_t elapsed_wall_ns = now_ns - slot.start_time_ns.load();
+
+        bool is_timeout = elapsed_wall_ns >= budget_ns;
+        if (timeout_policy.is_cpu_time)
+        {
+            clockid_t worker_cpu_clock;
+            std::int64_t elapsed_cpu_ns = 0;
+            if (0 == clock_getcpuclockid(worker.pid, &worker_cpu_clock))
+            {
+                elapsed_cpu_ns = readClock(worker_cpu_clock) - slot.start_cpu_time_ns.load();
+            }
+
+            std::int64_t wall_ceiling_ns = budget_ns * static_cast<std::int64_t>(timeout_policy.wall_ceiling_factor);
+            is_timeout = elapsed_cpu_ns >= budget_ns || elapsed_wall_ns >= wall_ceiling_ns;
+        }
+
+        if (is_timeout)
+        {
+            kill(worker.pid, SIGKILL);
+            worker.is_killed = true;
+
+            // Results the worker managed to produce before being killed are still valid.
+            drainRing(worker_index);
+            storeFailedResult(static_cast<std::size_t>(task_index), "", true);
+        }
+    }
+}
+
+void WorkerPool::reapWorkers()
+{
+    int status;
+    pid_t pid;
+
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+    {
+        for (std::size_t worker_index = 0; worker_index < workers.size(); worker_index++)
+        {
+            Worker& worker = workers[worker_index];
+            if (worker.pid != pid)
+            {
+                continue;
+            }
+
+            drainRing(worker_index);
+
+            std::int64_t task_index = getSlot(worker_index).current_task.load();
+            if (kIdle != task_index && !worker.is_killed)
+            {
+                std::string reason = WIFSIGNALED(status) ? "signal " + std::to_string(WTERMSIG(status))
+                                                         : "exit code " + std::to_string(WEXITSTATUS(status));
+                storeFailedResult(static_cast<std::size_t>(task_index), "Worker process crashed (" + reason + ")", false);
+            }
+
+            worker.pid = -1;
+
+            if (shared_state->next_task.load() < jobs.size())
+            {
+                spawnWorker(worker_index);
+            }
+        }
+    }
+}
+
+void WorkerPool::failLostJobs()
+{
+    for (std::size_t task_index = 0; task_index < jobs.size(); task_index++)
+    {
+        if (!results[task_index].has_value())
+        {
+            storeFailedResult(task_index, "Worker process crashed", false);
+        }
+    }
+}
+
+void WorkerPool::run()
+{
+    shared_memory_size = sizeof(SharedState) + num_workers * sizeof(WorkerSlot);
+    shared_memory = mmap(nullptr, shared_memory_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == shared_memory)
+    {
+        shared_memory = nullptr;
+        throw std::runtime_error("WorkerPool couldn't map shared memory: " + std::string(std::strerror(errno)));
+    }
+
+    shared_state = new (shared_memory) SharedState();
+    shared_state->next_task.store(0);
+    if (0 != sem_init(&shared_state->results_semaphore, 1, 0))
+    {
+        throw std::runtime_error("WorkerPool couldn't initialize a process-shared semaphore!");
+    }
+
+    for (std::size_t worker_index = 0; worker_index < num_workers; worker_index++)
+    {
+        new (&getSlot(worker_index)) WorkerSlot();
+        spawnWorker(worker_index);
+    }
+
+    while (num_results < jobs.size())
+    {
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += std::chrono::nanoseconds(kPollInterval).count();
+        deadline.tv_sec += deadline.tv_nsec / 1000000000;
+        deadline.tv_nsec %= 1000000000;
+
+        sem_timedwait(&shared_state->results_semaphore, &deadline);
+
+        for (std::size_t worker_index = 0; worker_index < workers.size(); worker_index++)
+        {
+            drainRing(worker_index);
+        }
+
+        enforceTimeouts();
+        reapWorkers();
+
+        bool is_any_worker_alive = std::any_of(workers.begin(), workers.end(), [](const Worker& worker) { return worker.pid > 0; });
+        if (!is_any_worker_alive)
+        {
+            failLostJobs();
+        }
+    }
+}
@@ -0,0 +1,188 @@
+#ifndef WORKER_POOL_H_
+#define WORKER_POOL_H_
+
+#include "task.h"
+#include "job.h"
+
+#include <sys/types.h>
+#include <semaphore.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <functional>
+
+/**
+ * @brief The WorkerPool class simulates algorithm - house pairs in pre-forked, isolated, worker processes.
+ *
+ * Workers are forked after all algorithms were dlopen()ed and all houses were read, so each worker owns a private
+ * copy of the algorithm handles, while the houses are shared read-only (copy-on-write) with the parent.
+ * Each worker returns its results through its own single-producer ring in shared memory, so a crashing worker can't
+ * corrupt other workers' results. A crashed or timed out worker is (killed,) reaped and respawned - its task is
+ * scored as a timeout, and no runaway thread is left behind.
+ */
+class WorkerPool
+{
+public:
+    /**
+     * @brief Called with each job's result as soon as it's stored (on the thread running the pool).
+     */
+    using ResultCallback = std::function<void(std::size_t job_index, const JobResult& result)>;
+
+private:
+    static constexpr const std::size_t kRingCapacity = 64;             // Results ring capacity (per worker).
+    static constexpr const std::size_t kMaxErrorLength = 256;          // Maximal length of a returned error message.
+    static constexpr const std::int64_t kIdle = -1;                    // Current task index of an idle worker.
+    static constexpr const auto kPollInterval = std::chrono::milliseconds(5); // Parent's maximal wait between checks.
+
+    /**
+     * @brief A job result, as returned through the shared memory ring.
+     */
+    struct RingEntry
+    {
+        std::size_t task_index;
+        std::size_t score;
+        std::int64_t wall_time_ns;
+        std::int64_t cpu_time_ns;
+        std::size_t num_steps;
+        std::size_t peak_memory_bytes;
+        StepLatencySummary step_latencies;              // The algorithm's step call latencies (if the job's steps were timed).
+        bool has_planner_stats;                         // Whether or not the algorithm reports its planner stats.
+        PlannerStats planner_stats;                     // The algorithm's planner stats (if it reports them).
+        char algorithm_error[kMaxErrorLength];
+    };
+
+    /**
+     * @brief A worker's shared memory area - its current task and its (single-producer, single-consumer) results ring.
+     */
+    struct WorkerSlot
+    {
+        std::atomic<std::int64_t> current_task;        // Index of the task being simulated (kIdle once its simulation ended).
+        std::atomic<std::int64_t> start_time_ns;       // CLOCK_MONOTONIC time the current task started at.
+        std::atomic<std::int64_t> start_cpu_time_ns;   // Worker's process CPU time when the current task started.
+        std::atomic<std::size_t> ring_head;            // Next entry to be consumed (written by the parent only).
+        std::atomic<std::size_t> ring_tail;            // Next entry to be produced (written by the worker only).
+        RingEntry ring[kRingCapacity];
+    };
+
+    /**
+     * @brief The pool's shared memory header (followed by a WorkerSlot per worker).
+     */
+    struct SharedState
+    {
+        std::atomic<std::size_t> next_task;            // Index of the next task to be claimed by a worker.
+        sem_t results_semaphore;                       // Posted by workers for each produced result.
+    };
+
+    /**
+     * @brief Parent-side bookkeeping of a worker process.
+     */
+    struct Worker
+    {
+        pid_t pid = -1;
+        bool is_killed = false;                        // Whether the worker was killed (by the parent) due to a timeout.
+    };
+
+    const std::vector<Job>& jobs;
+    const std::size_t num_workers;
+    const TimeoutPolicy timeout_policy;
+    const bool summary_only;
+    const ResultCallback on_result;                    // Called with each stored result (if set).
+
+    void* shared_memory = nullptr;
+    std::size_t shared_memory_size = 0;
+    SharedState* shared_state = nullptr;
+
+    std::vector<Worker> workers;
+    std::vector<std::optional<JobResult>> results;
+    std::size_t num_results = 0;
+
+    /**
+     * @brief Returns the shared memory area of a given worker.
+     */
+    WorkerSlot& getSlot(std::size_t worker_index) const;
+
+    /**
+     * @brief Forks a new worker process into a given worker index (whose slot is reset first).
+     *
+     * @throws std::runtime_error If fork() failed.
+     */
+    void spawnWorker(std::size_t worker_index);
+
+    /**
+     * @brief The main loop of a worker process - claims and simulates jobs until there are no more jobs. Never returns.
+     */
+    [[noreturn]] void workerMain(std::size_t worker_index);
+
+    /**
+     * @brief Simulates a single job (within a worker process) and returns its result into the worker's ring.
+     */
+    void simulateJob(WorkerSlot& slot, std::size_t task_index);
+
+    /**
+     * @brief Stores a job result (ignoring results of jobs which already have one, e.g. jobs timed out by the parent).
+     */
+    void storeResult(std::size_t task_index, JobResult&& result);
+
+    /**
+     * @brief Stores a timeout-scored result for a job which didn't complete (timed out or crashed).
+     */
+    void storeFailedResult(std::size_t task_index, const std::string& error_message, bool is_timeout);
+
+    /**
+     * @brief Consumes all results produced into a given worker's ring.
+     */
+    void drainRing(std::size_t worker_index);
+
+    /**
+     * @brief Kills workers whose current task exceeded its time budget.
+     */
+    void enforceTimeouts();
+
+    /**
+     * @brief Reaps exited workers, fails their in-flight task (if any), and respawns them while jobs remain.
+     */
+    void reapWorkers();
+
+    /**
+     * @brief Fails jobs which were claimed but never reported (a worker died right after claiming them).
+     */
+    void failLostJobs();
+
+public:
+    /**
+     * @param jobs The jobs to be simulated (must outlive the pool).
+     * @param num_workers The number of worker processes.
+     * @param timeout_policy How the jobs' time budgets are enforced.
+     * @param summary_only Whether workers should skip exporting the jobs' statistics (output) files.
+     * @param on_result Called with each job's result as soon as it's stored - in the order the jobs finish (optional).
+     */
+    WorkerPool(const std::vector<Job>& jobs,
+               std::size_t num_workers,
+               const TimeoutPolicy& timeout_policy,
+               bool summary_only,
+               ResultCallback on_result = nullptr);
+
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool& worker_pool) = delete;
+    WorkerPool& operator=(const WorkerPool& worker_pool) = delete;
+
+    /**
+     * @brief Runs all jobs. Returns only after all jobs finished (gracefully, crashed or timed out).
+     *
+     * @throws std::runtime_error If the shared memory couldn't be set-up or a worker couldn't be forked.
+     */
+    void run();
+
+    /**
+     * @brief Returns the result of a given job (valid after run() returned).
+     */
+    const JobResult& getResult(std::size_t job_index) const { return results.at(job_index).value(); }
+};
+
+#endif /* WORKER_POOL_H_ */
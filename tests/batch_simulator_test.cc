@@ -0,0 +1,180 @@
+#include "gtest/gtest.h"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/AlgorithmRegistrar.h"
+#include "common/enums.h"
+
+#include "simulator/batch_simulator.h"
+#include "simulator/deserializer.h"
+#include "simulator/simulator.h"
+
+#include "algorithm/a/greedy_algorithm.h"
+#include "algorithm/b/dfs_algorithm.h"
+
+namespace
+{
+    std::array<AlgorithmFactory, 2> algo_factories = {
+        []() { return std::make_unique<GreedyAlgorithm>(); },
+        []() { return std::make_unique<DFSAlgorithm>(); }
+    };
+
+    /**
+     * @brief Takes a given sequence of steps, and then stays forever.
+     */
+    class ScriptedAlgorithm : public AbstractAlgorithm
+    {
+        std::vector<Step> steps;
+        std::size_t num_calls = 0;
+    public:
+        explicit ScriptedAlgorithm(std::vector<Step> steps) : steps(std::move(steps)) {}
+
+        void setMaxSteps(std::size_t) override {}
+        void setWallsSensor(const WallsSensor&) override {}
+        void setDirtSensor(const DirtSensor&) override {}
+        void setBatteryMeter(const BatteryMeter&) override {}
+
+        Step nextStep() override
+        {
+            std::size_t step_index = num_calls++;
+            return (step_index < steps.size()) ? steps[step_index] : Step::Stay;
+        }
+    };
+
+    class BatchSimulatorTest : public testing::TestWithParam<AlgorithmFactory>
+    {
+    protected:
+        /**
+         * @brief Simulates each of the given houses separately, and all of them in a single batch, and compares the results.
+         */
+        static void expectBatchMatchesSimulators(const std::vector<std::string>& input_files, const AlgorithmFactory& algorithm_factory)
+        {
+            std::vector<HouseFile> house_files(input_files.size());
+            std::vector<const HouseFile*> batch_house_files;
+            for (std::size_t i = 0; i < input_files.size(); i++)
+            {
+                Deserializer::readHouseFile(input_files[i], house_files[i]);
+                batch_house_files.push_back(&house_files[i]);
+            }
+
+            BatchSimulator batch_simulator(batch_house_files, algorithm_factory);
+            batch_simulator.run();
+
+            ASSERT_EQ(input_files.size(), batch_simulator.getNumLanes());
+
+            for (std::size_t lane = 0; lane < input_files.size(); lane++)
+            {
+                std::unique_ptr<AbstractAlgorithm> algorithm = algorithm_factory();
+                Simulator simulator(house_files[lane]);
+                simulator.setAlgorithm(*algorithm);
+
+                std::size_t score;
+                std::string algorithm_error;
+                try
+                {
+                    score = simulator.run();
+                }
+
+                catch (const std::exception& exception)
+                {
+                    score = simulator.getTimeoutScore();
+                    algorithm_error = exception.what();
+                }
+
+                const SimulationStatistics& statistics = simulator.getSimulationStatistics();
+                const SimulationStatistics& lane_statistics = batch_simulator.getSimulationStatistics(lane);
+
+                EXPECT_EQ(score, batch_simulator.getScore(lane)) << input_files[lane];
+                EXPECT_EQ(algorithm_error, batch_simulator.getAlgorithmError(lane)) << input_files[lane];
+                EXPECT_EQ(statistics.num_steps_taken, lane_statistics.num_steps_taken) << input_files[lane];
+                EXPECT_EQ(statistics.step_history, lane_statistics.step_history) << input_files[lane];
+                EXPECT_EQ(statistics.mission_status, lane_statistics.mission_status) << input_files[lane];
+                EXPECT_EQ(statistics.dirt_left, lane_statistics.dirt_left) << input_files[lane];
+                EXPECT_EQ(statistics.is_at_docking_station, lane_statistics.is_at_docking_station) << input_files[lane];
+                EXPECT_FALSE(batch_simulator.isTimedOut(lane)) << input_files[lane];
+            }
+        }
+    };
+
+    TEST_P(BatchSimulatorTest, BatchMatchesSimulators)
+    {
+        expectBatchMatchesSimulators({"inputs/input_sanity.txt",
+                                      "inputs/input_maze.txt",
+                                      "inputs/input_minbattery.txt",
+                                      "inputs/input_distantdirt.txt",
+                                      "inputs/input_trappeddirt.txt",
+                                      "inputs/input_allchars.txt",
+                                      "inputs/input_filledline.txt",
+                                      "inputs/input_filledcol.txt",
+                                      "inputs/input_immediatefinish.txt",
+                                      "inputs/input_stepstaken.txt",
+                                      "inputs/input_sanity.txt"},
+                                     GetParam());
+    }
+
+    INSTANTIATE_TEST_SUITE_P(
+        BatchSimulatorTests,
+        BatchSimulatorTest,
+        testing::ValuesIn(algo_factories)
+    );
+
+    TEST(BatchSimulatorLanes, LanesEndIndependently)
+    {
+        const std::vector<std::vector<Step>> lane_steps = {
+            {Step::West, Step::Stay, Step::East, Step::Finish},     // Finished at the docking station
+            {Step::West, Step::Finish},                             // Lying (finished away from the docking station)
+            {Step::North},                                          // Moved into a wall
+            {Step::West, Step::West, Step::Stay}                    // Stays until the battery is exhausted (dead)
+        };
+
+        std::vector<const HouseFile*> house_files;
+        HouseFile house_file;
+        Deserializer::readHouseFile("inputs/input_sanity.txt", house_file);
+
+        for (std::size_t i = 0; i < lane_steps.size(); i++)
+        {
+            house_files.push_back(&house_file);
+        }
+
+        std::size_t next_lane = 0;
+        AlgorithmFactory scripted_factory = [&lane_steps, &next_lane]()
+        {
+            return std::make_unique<ScriptedAlgorithm>(lane_steps.at(next_lane++));
+        };
+
+        BatchSimulator batch_simulator(house_files, scripted_factory);
+        batch_simulator.run();
+
+        next_lane = 0;
+        for (std::size_t lane = 0; lane < lane_steps.size(); lane++)
+        {
+            std::unique_ptr<AbstractAlgorithm> algorithm = scripted_factory();
+            Simulator simulator(house_file);
+            simulator.setAlgorithm(*algorithm);
+
+            std::size_t score;
+            try
+            {
+                score = simulator.run();
+            }
+
+            catch (const std::exception& exception)
+            {
+                score = simulator.getTimeoutScore();
+                EXPECT_EQ(exception.what(), batch_simulator.getAlgorithmError(lane));
+            }
+
+            EXPECT_EQ(score, batch_simulator.getScore(lane)) << "lane " << lane;
+            EXPECT_EQ(simulator.getSimulationStatistics().mission_status, batch_simulator.getSimulationStatistics(lane).mission_status) << "lane " << lane;
+            EXPECT_EQ(simulator.getSimulationStatistics().num_steps_taken, batch_simulator.getSimulationStatistics(lane).num_steps_taken) << "lane " << lane;
+        }
+
+        EXPECT_EQ(Status::Finished, batch_simulator.getSimulationStatistics(0).mission_status);
+        EXPECT_EQ(Status::Dead, batch_simulator.getSimulationStatistics(1).mission_status);
+        EXPECT_FALSE(batch_simulator.getAlgorithmError(2).empty());
+        EXPECT_EQ(Status::Dead, batch_simulator.getSimulationStatistics(3).mission_status);
+    }
+}
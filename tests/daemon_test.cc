@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#include "daemon.h"
+#include "input_handler.h"
+
+#include "simulator/deserializer.h"
+#include "simulator/simulator.h"
+
+namespace
+{
+    const std::string kHousePath = "daemon_houses";
+    const std::string kAlgorithmPath = "daemon_algorithms";
+    const std::string kHouseName = "input_a";
+    const int kReplyTimeoutSeconds = 30;
+
+    /**
+     * @brief Connects to a daemon's socket (failing the calling test on error).
+     */
+    int connectDaemon(const std::string& socket_path)
+    {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+        int connection_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+        EXPECT_LE(0, connection_socket);
+
+        // Don't hang the test on a missing reply
+        timeval timeout = {.tv_sec = kReplyTimeoutSeconds, .tv_usec = 0};
+        setsockopt(connection_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        EXPECT_EQ(0, connect(connection_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+        return connection_socket;
+    }
+
+    /**
+     * @brief Sends a request line, and reads its reply - up to (and including) the first `END` line.
+     */
+    std::string request(int connection_socket, const std::string& request_line)
+    {
+        std::string line = request_line + '\n';
+        EXPECT_EQ(static_cast<ssize_t>(line.size()), send(connection_socket, line.data(), line.size(), MSG_NOSIGNAL));
+
+        std::string reply;
+        char read_buffer[1];
+        while (!reply.ends_with("END\n") && 1 == recv(connection_socket, read_buffer, sizeof(read_buffer), 0))
+        {
+            reply += read_buffer[0];
+        }
+
+        return reply;
+    }
+}
+
+TEST(DaemonTest, FailingJobRepliedOnce)
+{
+    Arguments arguments = {};
+    arguments.house_path = kHousePath;
+    arguments.algorithm_path = kAlgorithmPath;
+    arguments.num_threads = 1;
+    arguments.wall_ceiling_factor = 1;
+    arguments.daemon_socket = (std::filesystem::temp_directory_path() / ("daemon_test-" + std::to_string(getpid()) + ".sock")).string();
+
+    HouseFile house_file;
+    Deserializer::readHouseFile(std::filesystem::path(kHousePath) / (kHouseName + ".house"), house_file);
+    std::size_t failed_score = Simulator(house_file).getTimeoutScore();
+
+    Daemon daemon(arguments);
+    std::thread serve_thread([&daemon]() { daemon.serve(); });
+
+    int connection_socket = connectDaemon(arguments.daemon_socket.value());
+
+    // The algorithm's constructor throws within the worker process - which must report it (once), rather than
+    // unwinding into the daemon's own (forked) request handling and replying on its behalf.
+    EXPECT_EQ("ThrowingAlgorithm," + kHouseName + "," + std::to_string(failed_score) + "\n"
+              "ERROR,ThrowingAlgorithm,[house=" + kHouseName + "]ctor failed\n"
+              "END\n",
+              request(connection_socket, "run houses=" + kHouseName));
+
+    EXPECT_EQ("END\n", request(connection_socket, "shutdown"));
+
+    close(connection_socket);
+    serve_thread.join();
+}
@@ -4,6 +4,7 @@
 #include <memory>
 #include <cstdlib>
 
+#include "simulator/battery.h"
 #include "simulator/house.h"
 
 namespace
@@ -145,4 +146,67 @@ namespace
             simple_location.move(Step::West);
         }, std::out_of_range);
     }
+
+    TEST_F(HouseTest, SurroundingsMatchSensors)
+    {
+        House local_house(*house);
+        Battery battery(50);
+
+        EXPECT_THROW({
+            local_house.getSurroundings();
+        }, std::logic_error);
+
+        local_house.attachBatteryMeter(battery);
+
+        const Direction directions[] = {Direction::North, Direction::East, Direction::South, Direction::West};
+
+        for(int i = 0; i < 50; i++)
+        {
+            Surroundings surroundings = local_house.getSurroundings();
+
+            for (Direction direction : directions)
+            {
+                EXPECT_EQ(local_house.isWall(direction), SurroundingsSensor::isWall(surroundings.wall_mask, direction));
+            }
+
+            EXPECT_EQ(local_house.dirtLevel(), surroundings.dirt_level);
+            EXPECT_EQ(battery.getBatteryState(), surroundings.battery_state);
+
+            local_house.cleanCurrentPosition();
+            battery.discharge();
+
+            Step next_step = getNextStep();
+            if (Step::Finish != next_step && Step::Stay != next_step && local_house.isWall(static_cast<Direction>(next_step)))
+            {
+                continue;
+            }
+
+            local_house.move(next_step);
+        }
+    }
+
+    TEST_F(HouseTest, CopiesCleanIndependently)
+    {
+        std::vector<std::vector<bool>> wall_map;
+        std::vector<std::vector<unsigned int>> dirt_map;
+
+        wall_map.push_back({false, false});
+        dirt_map.push_back({3, 5});
+
+        House original(std::move(wall_map), std::move(dirt_map), Position(0,0));
+        House copy(original);
+
+        copy.cleanCurrentPosition();
+        EXPECT_EQ(2, copy.dirtLevel());
+        EXPECT_EQ(3, original.dirtLevel());
+        EXPECT_EQ(7, copy.getTotalDirtCount());
+        EXPECT_EQ(8, original.getTotalDirtCount());
+
+        original.move(Step::East);
+        original.cleanCurrentPosition();
+        EXPECT_EQ(4, original.dirtLevel());
+
+        copy.move(Step::East);
+        EXPECT_EQ(5, copy.dirtLevel());
+    }
 }
@@ -7,6 +7,9 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
+#include <algorithm>
+#include <utility>
 #include <sstream>
 #include <fstream>
 #include <iostream>
@@ -22,6 +25,16 @@
 
 namespace
 {
+    // The houses a run's variants (e.g. by single steps, or with cycle detection) are checked to keep its results on
+    const std::array<std::string, 6> kVariantInputFiles = {
+        "inputs/input_sanity.txt",
+        "inputs/input_maze.txt",
+        "inputs/input_minbattery.txt",
+        "inputs/input_distantdirt.txt",
+        "inputs/input_trappeddirt.txt",
+        "inputs/input_allchars.txt"
+    };
+
     std::array<AlgorithmFactory, 2> algo_factories = {
         []() { return std::make_unique<GreedyAlgorithm>(); },
         []() { return std::make_unique<DFSAlgorithm>(); }
@@ -49,6 +62,53 @@ namespace
         }
     };
 
+    /**
+     * @brief Hides a wrapped algorithm's macro step interface, so it's run by single steps.
+     */
+    class SingleStepAlgorithm : public AbstractAlgorithm
+    {
+        std::unique_ptr<AbstractAlgorithm> algorithm;
+    public:
+        SingleStepAlgorithm(std::unique_ptr<AbstractAlgorithm> algorithm) : algorithm(std::move(algorithm)) {}
+
+        void setMaxSteps(std::size_t max_steps) override { algorithm->setMaxSteps(max_steps); }
+        void setWallsSensor(const WallsSensor& walls_sensor) override { algorithm->setWallsSensor(walls_sensor); }
+        void setDirtSensor(const DirtSensor& dirt_sensor) override { algorithm->setDirtSensor(dirt_sensor); }
+        void setBatteryMeter(const BatteryMeter& battery_meter) override { algorithm->setBatteryMeter(battery_meter); }
+        Step nextStep() override { return algorithm->nextStep(); }
+    };
+
+    /**
+     * @brief Takes a given sequence of steps, and then loops over another sequence of steps forever (counting its calls).
+     */
+    class LoopingAlgorithm : public AbstractAlgorithm
+    {
+        std::vector<Step> prefix_steps;
+        std::vector<Step> loop_steps;
+        std::size_t num_calls = 0;
+    public:
+        LoopingAlgorithm(std::vector<Step> prefix_steps, std::vector<Step> loop_steps)
+            : prefix_steps(std::move(prefix_steps)), loop_steps(std::move(loop_steps)) {}
+
+        void setMaxSteps(std::size_t) override {}
+        void setWallsSensor(const WallsSensor&) override {}
+        void setDirtSensor(const DirtSensor&) override {}
+        void setBatteryMeter(const BatteryMeter&) override {}
+
+        Step nextStep() override
+        {
+            std::size_t step_index = num_calls++;
+            if (step_index < prefix_steps.size())
+            {
+                return prefix_steps[step_index];
+            }
+
+            return loop_steps[(step_index - prefix_steps.size()) % loop_steps.size()];
+        }
+
+        std::size_t getNumCalls() const { return num_calls; }
+    };
+
     class SimulatorTest : public testing::TestWithParam<AlgorithmFactory>
     {
         std::unique_ptr<AbstractAlgorithm> algorithm;
@@ -71,6 +131,50 @@ namespace
         {
             return simulator->getSimulationStatistics();
         }
+
+        /**
+         * @brief Sets a variant run up - sets its simulator's options, and creates its algorithm (by the given factory).
+         */
+        using VariantSetup = std::function<std::unique_ptr<AbstractAlgorithm>(Simulator&, const AlgorithmFactory&)>;
+
+        /**
+         * @brief Checks a finished variant run (beyond its results, which are compared to the plain run).
+         */
+        using VariantCheck = std::function<void(Simulator&)>;
+
+        /**
+         * @brief Expects a variant of the plain run (the parameter algorithm, with no simulator options) to keep its results,
+         * over each of the variant input files.
+         */
+        void expectSameRuns(const VariantSetup& setup, const VariantCheck& check = [](Simulator&) {})
+        {
+            for (const std::string& input_file : kVariantInputFiles)
+            {
+                SCOPED_TRACE(input_file);
+
+                HouseFile house_file;
+                Deserializer::readHouseFile(input_file, house_file);
+
+                std::unique_ptr<AbstractAlgorithm> plain_algorithm = GetParam()();
+                Simulator plain_simulator(house_file);
+                plain_simulator.setAlgorithm(*plain_algorithm);
+                std::size_t plain_score = plain_simulator.run();
+
+                Simulator variant_simulator(house_file);
+                std::unique_ptr<AbstractAlgorithm> variant_algorithm = setup(variant_simulator, GetParam());
+                variant_simulator.setAlgorithm(*variant_algorithm);
+                std::size_t variant_score = variant_simulator.run();
+
+                const SimulationStatistics& plain_statistics = plain_simulator.getSimulationStatistics();
+                const SimulationStatistics& variant_statistics = variant_simulator.getSimulationStatistics();
+
+                EXPECT_EQ(plain_statistics.step_history, variant_statistics.step_history);
+                EXPECT_EQ(plain_statistics.mission_status, variant_statistics.mission_status);
+                EXPECT_EQ(plain_score, variant_score);
+
+                check(variant_simulator);
+            }
+        }
     };
 
     TEST_P(SimulatorTest, RobotSanity)
@@ -251,6 +355,179 @@ namespace
         EXPECT_TRUE(second_statistics.is_at_docking_station);
     }
 
+    TEST_P(SimulatorTest, RobotResumedInSlices)
+    {
+        const std::size_t step_slice = 3;
+        auto algo_factory = GetParam();
+
+        HouseFile house_file;
+        Deserializer::readHouseFile("inputs/input_maze.txt", house_file);
+
+        std::unique_ptr<AbstractAlgorithm> whole_algorithm = algo_factory();
+        Simulator whole_simulator(house_file);
+        whole_simulator.setAlgorithm(*whole_algorithm);
+        std::size_t whole_score = whole_simulator.run();
+
+        std::unique_ptr<AbstractAlgorithm> sliced_algorithm = algo_factory();
+        Simulator sliced_simulator(house_file);
+        sliced_simulator.setAlgorithm(*sliced_algorithm);
+
+        std::size_t num_slices = 1;
+        while (!sliced_simulator.runFor(step_slice))
+        {
+            EXPECT_FALSE(sliced_simulator.isFinished());
+            EXPECT_EQ(num_slices * step_slice, sliced_simulator.getSimulationStatistics().step_history.size());
+            num_slices++;
+        }
+
+        EXPECT_TRUE(sliced_simulator.isFinished());
+        EXPECT_LT(1, num_slices);
+
+        // A finished simulation can't be resumed
+        EXPECT_TRUE(sliced_simulator.runFor(step_slice));
+
+        const SimulationStatistics& whole_statistics = whole_simulator.getSimulationStatistics();
+        const SimulationStatistics& sliced_statistics = sliced_simulator.getSimulationStatistics();
+
+        EXPECT_EQ(whole_statistics.step_history, sliced_statistics.step_history);
+        EXPECT_EQ(whole_statistics.mission_status, sliced_statistics.mission_status);
+        EXPECT_EQ(whole_score, sliced_statistics.score);
+    }
+
+    TEST_P(SimulatorTest, RobotMacroStepsMatchSingleSteps)
+    {
+        ASSERT_NE(nullptr, dynamic_cast<MacroStepAlgorithm*>(GetParam()().get()));
+
+        expectSameRuns([](Simulator&, const AlgorithmFactory& algo_factory) {
+            return std::make_unique<SingleStepAlgorithm>(algo_factory());
+        });
+    }
+
+    TEST_P(SimulatorTest, RobotForkedFromSnapshot)
+    {
+        auto algo_factory = GetParam();
+
+        HouseFile house_file;
+        Deserializer::readHouseFile("inputs/input_distantdirt.txt", house_file);
+
+        // Runs a simulation until its robot is back at the docking station and fully charged (false if it finished first)
+        auto runUntilCharged = [](Simulator& simulator)
+        {
+            do
+            {
+                if (simulator.runFor(1))
+                {
+                    return false;
+                }
+            }
+            while (!simulator.isSnapshotReady());
+
+            return true;
+        };
+
+        std::unique_ptr<AbstractAlgorithm> whole_algorithm = algo_factory();
+        Simulator whole_simulator(house_file);
+        whole_simulator.setAlgorithm(*whole_algorithm);
+        std::size_t whole_score = whole_simulator.run();
+        const std::vector<Step>& whole_history = whole_simulator.getSimulationStatistics().step_history;
+
+        // Forks of an initial snapshot are identical to the whole simulation
+        SimulatorSnapshot initial_snapshot = Simulator(house_file).takeSnapshot();
+        for (int i = 0; i < 2; i++)
+        {
+            std::unique_ptr<AbstractAlgorithm> forked_algorithm = algo_factory();
+            Simulator forked_simulator(house_file);
+            forked_simulator.restoreSnapshot(initial_snapshot);
+            forked_simulator.setAlgorithm(*forked_algorithm);
+
+            EXPECT_EQ(whole_score, forked_simulator.run());
+            EXPECT_EQ(whole_history, forked_simulator.getSimulationStatistics().step_history);
+        }
+
+        // A snapshot after the first charge cycle (its forks don't affect the simulation it was taken from)
+        std::unique_ptr<AbstractAlgorithm> prefix_algorithm = algo_factory();
+        Simulator prefix_simulator(house_file);
+        prefix_simulator.setAlgorithm(*prefix_algorithm);
+        ASSERT_TRUE(runUntilCharged(prefix_simulator));
+
+        SimulatorSnapshot snapshot = prefix_simulator.takeSnapshot();
+        std::size_t prefix_steps = snapshot.statistics.num_steps_taken;
+        std::size_t snapshot_dirt_left = prefix_simulator.getSimulationStatistics().dirt_left;
+
+        // A fresh run of the same algorithm, continued from the snapshot's state (with the steps left)
+        HouseFile continued_house_file = {
+            .name = house_file.name,
+            .max_steps = house_file.max_steps - prefix_steps,
+            .battery = snapshot.battery,
+            .house = snapshot.house
+        };
+
+        std::unique_ptr<AbstractAlgorithm> continued_algorithm = algo_factory();
+        Simulator continued_simulator(continued_house_file);
+        continued_simulator.setAlgorithm(*continued_algorithm);
+        std::size_t continued_score = continued_simulator.run();
+
+        std::vector<Step> combined_history(whole_history.begin(), whole_history.begin() + prefix_steps);
+        const std::vector<Step>& continued_history = continued_simulator.getSimulationStatistics().step_history;
+        combined_history.insert(combined_history.end(), continued_history.begin(), continued_history.end());
+
+        // The fork is scored for all of its steps (including the snapshot's) - against the original maximal number of steps
+        for (int i = 0; i < 2; i++)
+        {
+            std::unique_ptr<AbstractAlgorithm> forked_algorithm = algo_factory();
+            Simulator forked_simulator(house_file);
+            forked_simulator.restoreSnapshot(snapshot);
+            EXPECT_EQ(snapshot_dirt_left, forked_simulator.getSimulationStatistics().dirt_left);
+            EXPECT_EQ(prefix_steps, forked_simulator.getSimulationStatistics().num_steps_taken);
+
+            forked_simulator.setAlgorithm(*forked_algorithm);
+            EXPECT_EQ(continued_score + prefix_steps, forked_simulator.run());
+            EXPECT_EQ(combined_history, forked_simulator.getSimulationStatistics().step_history);
+        }
+
+        EXPECT_EQ(whole_score, prefix_simulator.run());
+        EXPECT_EQ(whole_history, prefix_simulator.getSimulationStatistics().step_history);
+
+        // The snapshot shares its step history - which its forks' histories (and their own snapshots') start with
+        EXPECT_TRUE(snapshot.statistics.step_history.empty());
+
+        std::unique_ptr<AbstractAlgorithm> middle_algorithm = algo_factory();
+        Simulator middle_simulator(house_file);
+        middle_simulator.restoreSnapshot(snapshot);
+        middle_simulator.setAlgorithm(*middle_algorithm);
+        ASSERT_TRUE(runUntilCharged(middle_simulator));
+
+        SimulatorSnapshot middle_snapshot = middle_simulator.takeSnapshot();
+        std::unique_ptr<AbstractAlgorithm> last_algorithm = algo_factory();
+        Simulator last_simulator(house_file);
+        last_simulator.restoreSnapshot(middle_snapshot);
+        last_simulator.setAlgorithm(*last_algorithm);
+        last_simulator.run();
+
+        const std::vector<Step>& middle_history = middle_simulator.getSimulationStatistics().step_history;
+        const std::vector<Step>& last_history = last_simulator.getSimulationStatistics().step_history;
+        ASSERT_LT(prefix_steps, middle_history.size());
+        ASSERT_LE(middle_history.size(), last_history.size());
+        EXPECT_TRUE(std::equal(combined_history.begin(), combined_history.begin() + middle_history.size(), middle_history.begin()));
+        EXPECT_TRUE(std::equal(middle_history.begin(), middle_history.end(), last_history.begin()));
+
+        // Snapshots are restored before setting an algorithm, and taken before the simulation finishes
+        EXPECT_THROW(last_simulator.restoreSnapshot(snapshot), std::logic_error);
+        EXPECT_THROW(last_simulator.takeSnapshot(), std::logic_error);
+
+        // Snapshots are taken (and restored) with the robot docked and fully charged only
+        std::unique_ptr<AbstractAlgorithm> away_algorithm = algo_factory();
+        Simulator away_simulator(house_file);
+        away_simulator.setAlgorithm(*away_algorithm);
+        ASSERT_FALSE(away_simulator.runFor(1));
+        EXPECT_FALSE(away_simulator.isSnapshotReady());
+        EXPECT_THROW(away_simulator.takeSnapshot(), std::logic_error);
+
+        SimulatorSnapshot drained_snapshot = snapshot;
+        drained_snapshot.battery.discharge();
+        EXPECT_THROW(Simulator(house_file).restoreSnapshot(drained_snapshot), std::logic_error);
+    }
+
     TEST_P(SimulatorTest, RobotImmediateFinish)
     {
         const std::size_t total_dirt = 45;
@@ -283,6 +560,84 @@ namespace
         EXPECT_EQ(statistics.num_steps_taken, statistics.score);
     }
 
+    TEST_P(SimulatorTest, RobotCycleDetectionKeepsResults)
+    {
+        expectSameRuns([](Simulator& simulator, const AlgorithmFactory& algo_factory) {
+            simulator.enableCycleDetection(1);
+            return algo_factory();
+        });
+    }
+
+    TEST_P(SimulatorTest, RobotStepTimingKeepsResults)
+    {
+        HouseFile house_file;
+        Deserializer::readHouseFile("inputs/input_sanity.txt", house_file);
+
+        std::unique_ptr<AbstractAlgorithm> untimed_algorithm = GetParam()();
+        Simulator untimed_simulator(house_file);
+        untimed_simulator.setAlgorithm(*untimed_algorithm);
+        untimed_simulator.run();
+
+        EXPECT_EQ(nullptr, untimed_simulator.getStepLatencies());
+
+        // Timed by single steps - a latency per step call
+        expectSameRuns([](Simulator& simulator, const AlgorithmFactory& algo_factory) {
+            simulator.enableStepTiming(true);
+            return std::make_unique<SingleStepAlgorithm>(algo_factory());
+        }, [](Simulator& simulator) {
+            const StepLatencyHistogram* step_latencies = simulator.getStepLatencies();
+            ASSERT_NE(nullptr, step_latencies);
+
+            // The last call (its Finish step, or the step beyond MaxSteps) isn't taken
+            std::size_t num_steps_taken = simulator.getSimulationStatistics().num_steps_taken;
+            EXPECT_GE(step_latencies->getCount(), num_steps_taken);
+            EXPECT_LE(step_latencies->getCount(), num_steps_taken + 1);
+
+            StepLatencySummary summary = step_latencies->getSummary();
+            EXPECT_LE(summary.p50, summary.p99);
+            EXPECT_LE(summary.p99, summary.p999);
+            EXPECT_LE(summary.p999, summary.max);
+        });
+    }
+
+    TEST_P(SimulatorTest, RobotPlannerStats)
+    {
+        // An algorithm which doesn't implement the PlannerStatsAlgorithm interface reports none
+        expectSameRuns([](Simulator&, const AlgorithmFactory& algo_factory) {
+            return std::make_unique<SingleStepAlgorithm>(algo_factory());
+        }, [](Simulator& simulator) {
+            EXPECT_FALSE(simulator.getPlannerStats().has_value());
+        });
+
+        expectSameRuns([](Simulator&, const AlgorithmFactory& algo_factory) {
+            return algo_factory();
+        }, [](Simulator& simulator) {
+            std::optional<PlannerStats> planner_stats = simulator.getPlannerStats();
+            ASSERT_TRUE(planner_stats.has_value());
+
+            std::size_t num_decisions = 0;
+            for (std::size_t decision_count : planner_stats->decisions)
+            {
+                num_decisions += decision_count;
+            }
+
+            // Each decision searches a path back to the station, and checks whether all reachable positions are cleaned
+            EXPECT_GT(num_decisions, 0);
+            EXPECT_EQ(num_decisions, planner_stats->station_searches);
+            EXPECT_EQ(num_decisions, planner_stats->reachability_searches);
+
+            EXPECT_EQ(planner_stats->num_searches, planner_stats->station_searches
+                                                   + planner_stats->todo_searches
+                                                   + planner_stats->reachability_searches
+                                                   + planner_stats->validity_searches
+                                                   + planner_stats->target_searches);
+
+            EXPECT_LE(planner_stats->nodes_expanded, planner_stats->path_tree_nodes);
+            EXPECT_LE(planner_stats->peak_path_tree_nodes, planner_stats->path_tree_nodes);
+            EXPECT_GE(planner_stats->path_tree_nodes, planner_stats->num_searches);
+        });
+    }
+
     // Instantiate the test suite with the object pointers
     INSTANTIATE_TEST_SUITE_P(
         SimulatorTests,                     // Name of the test suite
@@ -426,4 +781,56 @@ namespace
         EXPECT_EQ(lying_penalty
                   + mock_algorithm.getMaxSteps(), statistics.score);
     }
+
+    TEST(CycleDetection, LivelockedRobotScoredAsFullRun)
+    {
+        const std::vector<std::pair<std::vector<Step>, std::vector<Step>>> looping_paths = {
+            // Cleans next to the docking station, then oscillates while charging (ends at the docking station)
+            {{Step::West, Step::Stay, Step::Stay, Step::East}, {Step::West, Step::East, Step::Stay}},
+            // Oscillates while charging, and ends the steps away from the docking station
+            {{Step::West, Step::Stay, Step::East}, {Step::Stay, Step::West, Step::East}},
+            // Oscillates away from the docking station until the battery is exhausted (no cycle)
+            {{Step::West, Step::West}, {Step::West, Step::East}}
+        };
+
+        HouseFile house_file;
+        Deserializer::readHouseFile("inputs/input_sanity.txt", house_file);
+
+        for (const auto& [prefix_steps, loop_steps] : looping_paths)
+        {
+            LoopingAlgorithm full_run_algorithm(prefix_steps, loop_steps);
+            Simulator full_run_simulator(house_file);
+            full_run_simulator.setAlgorithm(full_run_algorithm);
+            std::size_t full_run_score = full_run_simulator.run();
+            const SimulationStatistics& full_run_statistics = full_run_simulator.getSimulationStatistics();
+
+            for (std::size_t check_interval : {1, 7})
+            {
+                LoopingAlgorithm algorithm(prefix_steps, loop_steps);
+                Simulator simulator(house_file);
+                simulator.enableCycleDetection(check_interval);
+                simulator.setAlgorithm(algorithm);
+
+                EXPECT_EQ(full_run_score, simulator.run());
+
+                const SimulationStatistics& statistics = simulator.getSimulationStatistics();
+                EXPECT_EQ(full_run_statistics.num_steps_taken, statistics.num_steps_taken);
+                EXPECT_EQ(full_run_statistics.step_history, statistics.step_history);
+                EXPECT_EQ(full_run_statistics.mission_status, statistics.mission_status);
+                EXPECT_EQ(full_run_statistics.dirt_left, statistics.dirt_left);
+                EXPECT_EQ(full_run_statistics.is_at_docking_station, statistics.is_at_docking_station);
+
+                // A livelocked robot is finished early (with no further algorithm calls)
+                if (Status::Working == full_run_statistics.mission_status)
+                {
+                    EXPECT_LT(algorithm.getNumCalls(), full_run_algorithm.getNumCalls() / 2);
+                }
+
+                else
+                {
+                    EXPECT_EQ(full_run_algorithm.getNumCalls(), algorithm.getNumCalls());
+                }
+            }
+        }
+    }
 }
@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "simulator/step_latency_histogram.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    TEST(StepLatencyHistogramTest, EmptyHistogram)
+    {
+        StepLatencyHistogram histogram;
+
+        EXPECT_EQ(0, histogram.getCount());
+        EXPECT_EQ(0ns, histogram.getMax());
+        EXPECT_EQ(0ns, histogram.getPercentile(0.5));
+
+        StepLatencySummary summary = histogram.getSummary();
+        EXPECT_EQ(0, summary.num_calls);
+        EXPECT_EQ(0ns, summary.p999);
+    }
+
+    TEST(StepLatencyHistogramTest, SmallLatenciesAreExact)
+    {
+        StepLatencyHistogram histogram;
+
+        // 1ns up to 10ns - each recorded once
+        for (std::int64_t latency = 1; latency <= 10; latency++)
+        {
+            histogram.record(std::chrono::nanoseconds(latency));
+        }
+
+        EXPECT_EQ(10, histogram.getCount());
+        EXPECT_EQ(1ns, histogram.getPercentile(0));
+        EXPECT_EQ(5ns, histogram.getPercentile(0.5));
+        EXPECT_EQ(9ns, histogram.getPercentile(0.9));
+        EXPECT_EQ(10ns, histogram.getPercentile(1));
+        EXPECT_EQ(10ns, histogram.getMax());
+    }
+
+    TEST(StepLatencyHistogramTest, PercentilesWithinRelativeError)
+    {
+        StepLatencyHistogram histogram;
+
+        // 1us up to 1ms
+        const std::size_t num_latencies = 1000;
+        for (std::size_t i = 1; i <= num_latencies; i++)
+        {
+            histogram.record(std::chrono::microseconds(i));
+        }
+
+        // A percentile is never below the true one, and above it by 1 / 16 of it at most
+        for (auto [percentile, true_latency] : {std::pair{0.5, 500us}, std::pair{0.99, 990us}, std::pair{0.999, 999us}})
+        {
+            std::chrono::nanoseconds latency = histogram.getPercentile(percentile);
+
+            EXPECT_GE(latency, true_latency) << percentile;
+            EXPECT_LE(latency, true_latency + true_latency / 16) << percentile;
+        }
+
+        EXPECT_EQ(1000us, histogram.getMax());
+        EXPECT_EQ(1000us, histogram.getPercentile(1));
+    }
+
+    TEST(StepLatencyHistogramTest, OutlierDominatesTail)
+    {
+        StepLatencyHistogram histogram;
+
+        for (std::size_t i = 0; i < 999; i++)
+        {
+            histogram.record(100ns);
+        }
+        histogram.record(1s);
+
+        StepLatencySummary summary = histogram.getSummary();
+        EXPECT_EQ(1000, summary.num_calls);
+        EXPECT_LE(summary.p50, 106ns);
+        EXPECT_LE(summary.p99, 106ns);
+        EXPECT_EQ(1s, summary.max);
+        EXPECT_EQ(1s, histogram.getPercentile(1));
+    }
+
+    TEST(StepLatencyHistogramTest, ExtremeLatencies)
+    {
+        StepLatencyHistogram histogram;
+
+        histogram.record(-5ns);
+        histogram.record(std::chrono::nanoseconds::max());
+
+        EXPECT_EQ(2, histogram.getCount());
+        EXPECT_EQ(0ns, histogram.getPercentile(0.5));
+        EXPECT_EQ(std::chrono::nanoseconds::max(), histogram.getPercentile(1));
+    }
+}
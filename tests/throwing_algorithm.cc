@@ -0,0 +1,24 @@
+#include "common/abstract_algorithm.h"
+#include "common/enums.h"
+
+#include "algorithm/AlgorithmRegistration.h"
+
+#include <stdexcept>
+
+/**
+ * @brief An algorithm plugin which can't even be constructed - so each of its jobs fails before being simulated.
+ */
+class ThrowingAlgorithm final : public AbstractAlgorithm
+{
+public:
+    ThrowingAlgorithm() { throw std::runtime_error("ctor failed"); }
+
+    void setMaxSteps(std::size_t) override {}
+    void setWallsSensor(const WallsSensor&) override {}
+    void setDirtSensor(const DirtSensor&) override {}
+    void setBatteryMeter(const BatteryMeter&) override {}
+
+    Step nextStep() override { return Step::Finish; }
+};
+
+REGISTER_ALGORITHM(ThrowingAlgorithm);
@@ -0,0 +1,435 @@
+#include <string>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <exception>
+#include <filesystem>
+#include <string_view>
+
+/**
+ * house_generator - generates a corpus of valid `.house` files, for benchmarking the simulator and algorithms at scale.
+ *
+ * Generation is deterministic: a house is a function of the parameters and its seed (the base seed plus its index) only.
+ * Random numbers are drawn from std::mt19937_64 directly (rather than through std::*_distribution, whose results differ
+ * between standard library implementations) - so the same parameters produce the same houses on any platform.
+ *
+ * Usage: house_generator [-output_path=<path>] [-count=<num>] [-seed=<num>] [-rows=<num>] [-cols=<num>] [-layout=open|rooms|maze]
+ *                        [-wall_density=<fraction>] [-room_size=<num>] [-dirt=uniform|clustered] [-dirt_density=<fraction>]
+ *                        [-max_dirt=<1-9>] [-max_steps=<num>] [-max_battery=<num>]
+ */
+
+namespace Constants
+{
+    const char kWall = 'W';
+    const char kEmpty = ' ';
+    const char kDockingStation = 'D';
+
+    const std::size_t kMaxDimension = 10000;
+    const std::size_t kClusterArea = 400;          // The average number of cells per dirt cluster (clustered dirt).
+
+    const std::string kHouseExtension = ".house";
+    const std::string kUsage = "Usage: house_generator [-output_path=<path>] [-count=<num>] [-seed=<num>] [-rows=<num>] [-cols=<num>] "
+                               "[-layout=open|rooms|maze] [-wall_density=<fraction>] [-room_size=<num>] [-dirt=uniform|clustered] "
+                               "[-dirt_density=<fraction>] [-max_dirt=<1-9>] [-max_steps=<num>] [-max_battery=<num>]";
+}
+
+enum class Layout { Open, Rooms, Maze };
+enum class DirtDistribution { Uniform, Clustered };
+
+struct GeneratorArguments
+{
+    std::filesystem::path output_path = ".";
+    std::size_t count = 1;
+    std::uint64_t seed = 0;
+    std::size_t rows = 64;
+    std::size_t cols = 64;
+    Layout layout = Layout::Rooms;
+    double wall_density = 0.2;                      // The fraction of interior cells which are walls (open plan layout).
+    std::size_t room_size = 8;                      // The side of a room, including its walls (rooms layout).
+    DirtDistribution dirt = DirtDistribution::Uniform;
+    double dirt_density = 0.3;                      // The fraction of empty cells which are dirty.
+    unsigned int max_dirt = 9;                      // The maximal dirt level of a cell.
+    std::optional<std::size_t> max_steps;           // Defaults to 4 steps per cell.
+    std::optional<std::size_t> max_battery;         // Defaults to 4 times the house's perimeter.
+};
+
+/**
+ * @brief A deterministic random source (see the file's comment).
+ */
+class RandomSource
+{
+    std::mt19937_64 engine;
+
+public:
+    explicit RandomSource(std::uint64_t seed) : engine(seed) {}
+
+    /**
+     * @brief Returns a number in [0, bound) (bound must be positive).
+     */
+    std::size_t below(std::size_t bound) { return static_cast<std::size_t>(engine() % bound); }
+
+    /**
+     * @brief Returns true with a given probability.
+     */
+    bool chance(double probability) { return static_cast<double>(engine() >> 11) * 0x1.0p-53 < probability; }
+};
+
+/**
+ * @brief A house grid, surrounded by walls.
+ */
+class HouseGrid
+{
+    std::size_t rows;
+    std::size_t cols;
+    std::vector<char> cells;
+
+public:
+    HouseGrid(std::size_t rows, std::size_t cols, char block) : rows(rows), cols(cols), cells(rows * cols, block) {}
+
+    std::size_t getRows() const { return rows; }
+    std::size_t getCols() const { return cols; }
+    char& at(std::size_t row, std::size_t col) { return cells[row * cols + col]; }
+    char at(std::size_t row, std::size_t col) const { return cells[row * cols + col]; }
+
+    bool isBorder(std::size_t row, std::size_t col) const { return 0 == row || 0 == col || rows - 1 == row || cols - 1 == col; }
+
+    void surroundByWalls()
+    {
+        for (std::size_t row = 0; row < rows; row++)
+        {
+            at(row, 0) = Constants::kWall;
+            at(row, cols - 1) = Constants::kWall;
+        }
+
+        for (std::size_t col = 0; col < cols; col++)
+        {
+            at(0, col) = Constants::kWall;
+            at(rows - 1, col) = Constants::kWall;
+        }
+    }
+};
+
+/**
+ * @brief Open plan - scattered walls, with the given density (some cells may be unreachable, as in a real house).
+ */
+void generateOpenPlan(HouseGrid& grid, const GeneratorArguments& arguments, RandomSource& random)
+{
+    for (std::size_t row = 1; row + 1 < grid.getRows(); row++)
+    {
+        for (std::size_t col = 1; col + 1 < grid.getCols(); col++)
+        {
+            grid.at(row, col) = random.chance(arguments.wall_density) ? Constants::kWall : Constants::kEmpty;
+        }
+    }
+}
+
+/**
+ * @brief Rooms - a lattice of square rooms, with a door in each wall between adjacent rooms (so all rooms are connected).
+ */
+void generateRooms(HouseGrid& grid, const GeneratorArguments& arguments, RandomSource& random)
+{
+    std::size_t room_size = std::max<std::size_t>(3, arguments.room_size);
+
+    for (std::size_t row = 1; row + 1 < grid.getRows(); row++)
+    {
+        for (std::size_t col = 1; col + 1 < grid.getCols(); col++)
+        {
+            bool is_room_wall = (0 == row % (room_size - 1)) || (0 == col % (room_size - 1));
+            grid.at(row, col) = is_room_wall ? Constants::kWall : Constants::kEmpty;
+        }
+    }
+
+    // Horizontal walls (between vertically adjacent rooms), then vertical ones - a door per wall segment
+    for (std::size_t wall_row = room_size - 1; wall_row + 1 < grid.getRows(); wall_row += room_size - 1)
+    {
+        for (std::size_t first_col = 1; first_col + 1 < grid.getCols(); first_col += room_size - 1)
+        {
+            std::size_t segment_length = std::min(room_size - 2, grid.getCols() - 1 - first_col);
+            grid.at(wall_row, first_col + random.below(segment_length)) = Constants::kEmpty;
+        }
+    }
+
+    for (std::size_t wall_col = room_size - 1; wall_col + 1 < grid.getCols(); wall_col += room_size - 1)
+    {
+        for (std::size_t first_row = 1; first_row + 1 < grid.getRows(); first_row += room_size - 1)
+        {
+            std::size_t segment_length = std::min(room_size - 2, grid.getRows() - 1 - first_row);
+            grid.at(first_row + random.below(segment_length), wall_col) = Constants::kEmpty;
+        }
+    }
+}
+
+/**
+ * @brief Maze - a perfect maze (a single path between any two passages), carved by an iterative randomized DFS.
+ */
+void generateMaze(HouseGrid& grid, RandomSource& random)
+{
+    // Passages are carved on odd coordinates - a maze cell is (2i + 1, 2j + 1)
+    std::size_t maze_rows = (grid.getRows() - 1) / 2;
+    std::size_t maze_cols = (grid.getCols() - 1) / 2;
+
+    std::vector<std::pair<std::size_t, std::size_t>> stack = {{0, 0}};
+    grid.at(1, 1) = Constants::kEmpty;
+
+    while (!stack.empty())
+    {
+        auto [maze_row, maze_col] = stack.back();
+
+        std::pair<std::size_t, std::size_t> neighbors[4];
+        std::size_t num_neighbors = 0;
+
+        auto addNeighbor = [&](std::size_t row, std::size_t col)
+        {
+            if (Constants::kWall == grid.at(2 * row + 1, 2 * col + 1))
+            {
+                neighbors[num_neighbors++] = {row, col};
+            }
+        };
+
+        if (maze_row > 0) addNeighbor(maze_row - 1, maze_col);
+        if (maze_row + 1 < maze_rows) addNeighbor(maze_row + 1, maze_col);
+        if (maze_col > 0) addNeighbor(maze_row, maze_col - 1);
+        if (maze_col + 1 < maze_cols) addNeighbor(maze_row, maze_col + 1);
+
+        if (0 == num_neighbors)
+        {
+            stack.pop_back();
+            continue;
+        }
+
+        auto [next_row, next_col] = neighbors[random.below(num_neighbors)];
+        grid.at(maze_row + next_row + 1, maze_col + next_col + 1) = Constants::kEmpty;   // The wall between them
+        grid.at(2 * next_row + 1, 2 * next_col + 1) = Constants::kEmpty;
+        stack.push_back({next_row, next_col});
+    }
+}
+
+/**
+ * @brief Places the docking station on a random empty cell (making one empty, if there's none).
+ */
+void placeDockingStation(HouseGrid& grid, RandomSource& random)
+{
+    std::size_t num_empty_cells = 0;
+    for (std::size_t row = 1; row + 1 < grid.getRows(); row++)
+    {
+        for (std::size_t col = 1; col + 1 < grid.getCols(); col++)
+        {
+            num_empty_cells += (Constants::kEmpty == grid.at(row, col)) ? 1 : 0;
+        }
+    }
+
+    if (0 == num_empty_cells)
+    {
+        grid.at(1, 1) = Constants::kDockingStation;
+        return;
+    }
+
+    std::size_t dock_index = random.below(num_empty_cells);
+    for (std::size_t row = 1; row + 1 < grid.getRows(); row++)
+    {
+        for (std::size_t col = 1; col + 1 < grid.getCols(); col++)
+        {
+            if (Constants::kEmpty == grid.at(row, col) && 0 == dock_index--)
+            {
+                grid.at(row, col) = Constants::kDockingStation;
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Spreads dirt over the empty cells - uniformly, or in clusters (with the same overall density).
+ */
+void spreadDirt(HouseGrid& grid, const GeneratorArguments& arguments, RandomSource& random)
+{
+    auto dirtLevel = [&]() { return static_cast<char>('1' + random.below(arguments.max_dirt)); };
+
+    if (DirtDistribution::Uniform == arguments.dirt)
+    {
+        for (std::size_t row = 1; row + 1 < grid.getRows(); row++)
+        {
+            for (std::size_t col = 1; col + 1 < grid.getCols(); col++)
+            {
+                if (Constants::kEmpty == grid.at(row, col) && random.chance(arguments.dirt_density))
+                {
+                    grid.at(row, col) = dirtLevel();
+                }
+            }
+        }
+
+        return;
+    }
+
+    // Clusters are squares covering (about) dirt_density of the house
+    std::size_t num_cells = grid.getRows() * grid.getCols();
+    std::size_t num_clusters = std::max<std::size_t>(1, num_cells / Constants::kClusterArea);
+    double cluster_area = arguments.dirt_density * static_cast<double>(num_cells) / static_cast<double>(num_clusters);
+    std::size_t cluster_radius = static_cast<std::size_t>(std::max(0.0, (std::sqrt(cluster_area) - 1) / 2));
+
+    for (std::size_t cluster = 0; cluster < num_clusters; cluster++)
+    {
+        std::size_t center_row = random.below(grid.getRows());
+        std::size_t center_col = random.below(grid.getCols());
+
+        for (std::size_t row = center_row - std::min(center_row, cluster_radius); row <= center_row + cluster_radius && row < grid.getRows(); row++)
+        {
+            for (std::size_t col = center_col - std::min(center_col, cluster_radius); col <= center_col + cluster_radius && col < grid.getCols(); col++)
+            {
+                if (Constants::kEmpty == grid.at(row, col))
+                {
+                    grid.at(row, col) = dirtLevel();
+                }
+            }
+        }
+    }
+}
+
+HouseGrid generateHouse(const GeneratorArguments& arguments, std::uint64_t seed)
+{
+    RandomSource random(seed);
+    HouseGrid grid(arguments.rows, arguments.cols, Constants::kWall);
+
+    switch (arguments.layout)
+    {
+        case Layout::Open:
+            generateOpenPlan(grid, arguments, random);
+            break;
+
+        case Layout::Rooms:
+            generateRooms(grid, arguments, random);
+            break;
+
+        case Layout::Maze:
+            generateMaze(grid, random);
+            break;
+    }
+
+    grid.surroundByWalls();
+    placeDockingStation(grid, random);
+    spreadDirt(grid, arguments, random);
+
+    return grid;
+}
+
+void writeHouse(const std::filesystem::path& house_path, const std::string& house_name, const HouseGrid& grid, const GeneratorArguments& arguments)
+{
+    std::size_t max_steps = arguments.max_steps.value_or(4 * grid.getRows() * grid.getCols());
+    std::size_t max_battery = arguments.max_battery.value_or(8 * (grid.getRows() + grid.getCols()));
+
+    std::ofstream house_file(house_path, std::ios::trunc);
+    if (!house_file.is_open())
+    {
+        throw std::runtime_error("Couldn't open house file \"" + house_path.string() + "\"");
+    }
+
+    house_file << house_name << "\n"
+               << "MaxSteps = " << max_steps << "\n"
+               << "MaxBattery = " << max_battery << "\n"
+               << "Rows = " << grid.getRows() << "\n"
+               << "Cols = " << grid.getCols() << "\n";
+
+    std::string house_row(grid.getCols(), Constants::kWall);
+    for (std::size_t row = 0; row < grid.getRows(); row++)
+    {
+        for (std::size_t col = 0; col < grid.getCols(); col++)
+        {
+            house_row[col] = grid.at(row, col);
+        }
+
+        house_file << house_row << "\n";
+    }
+
+    if (!house_file.good())
+    {
+        throw std::runtime_error("Couldn't write house file \"" + house_path.string() + "\"");
+    }
+}
+
+/**
+ * @brief Parses a single command line argument into the generator's arguments.
+ *
+ * @throws std::invalid_argument On an invalid argument.
+ */
+void parseArgument(std::string_view raw_argument, GeneratorArguments& arguments)
+{
+    std::size_t value_position = raw_argument.find("=");
+    if (std::string_view::npos == value_position)
+    {
+        throw std::invalid_argument("Invalid argument: " + std::string(raw_argument));
+    }
+
+    std::string_view name = raw_argument.substr(0, value_position);
+    std::string value(raw_argument.substr(value_position + 1));
+
+    if ("-output_path" == name) arguments.output_path = value;
+    else if ("-count" == name) arguments.count = std::stoul(value);
+    else if ("-seed" == name) arguments.seed = std::stoull(value);
+    else if ("-rows" == name) arguments.rows = std::stoul(value);
+    else if ("-cols" == name) arguments.cols = std::stoul(value);
+    else if ("-wall_density" == name) arguments.wall_density = std::stod(value);
+    else if ("-room_size" == name) arguments.room_size = std::stoul(value);
+    else if ("-dirt_density" == name) arguments.dirt_density = std::stod(value);
+    else if ("-max_dirt" == name) arguments.max_dirt = static_cast<unsigned int>(std::stoul(value));
+    else if ("-max_steps" == name) arguments.max_steps = std::stoul(value);
+    else if ("-max_battery" == name) arguments.max_battery = std::stoul(value);
+    else if ("-layout" == name && "open" == value) arguments.layout = Layout::Open;
+    else if ("-layout" == name && "rooms" == value) arguments.layout = Layout::Rooms;
+    else if ("-layout" == name && "maze" == value) arguments.layout = Layout::Maze;
+    else if ("-dirt" == name && "uniform" == value) arguments.dirt = DirtDistribution::Uniform;
+    else if ("-dirt" == name && "clustered" == value) arguments.dirt = DirtDistribution::Clustered;
+    else throw std::invalid_argument("Invalid argument: " + std::string(raw_argument));
+
+    if (arguments.rows < 3 || arguments.cols < 3 || arguments.rows > Constants::kMaxDimension || arguments.cols > Constants::kMaxDimension)
+    {
+        throw std::invalid_argument("House dimensions must be between 3 and " + std::to_string(Constants::kMaxDimension));
+    }
+
+    if (arguments.max_dirt < 1 || arguments.max_dirt > 9)
+    {
+        throw std::invalid_argument("Maximal dirt level must be between 1 and 9");
+    }
+
+    // Written as negations, to reject NaN as well
+    if (!(arguments.wall_density >= 0 && arguments.wall_density <= 1) || !(arguments.dirt_density >= 0 && arguments.dirt_density <= 1))
+    {
+        throw std::invalid_argument("Wall and dirt densities must be between 0 and 1");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    GeneratorArguments arguments;
+
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            parseArgument(argv[i], arguments);
+        }
+
+        std::filesystem::create_directories(arguments.output_path);
+
+        for (std::size_t i = 0; i < arguments.count; i++)
+        {
+            std::string house_name = "house_" + std::to_string(arguments.seed + i);
+            HouseGrid grid = generateHouse(arguments, arguments.seed + i);
+            writeHouse(arguments.output_path / (house_name + Constants::kHouseExtension), house_name, grid, arguments);
+        }
+    }
+
+    catch (const std::exception& exception)
+    {
+        std::cerr << exception.what() << std::endl << Constants::kUsage << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}